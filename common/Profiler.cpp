@@ -0,0 +1,284 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   Profiler.cpp                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: benpicar <benpicar@student.42mulhouse.fr>  +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 18:42:15 by benpicar          #+#    #+#             */
+/*   Updated: 2026/10/19 18:42:15 by benpicar         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "Profiler.hpp"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <iomanip>
+#include <new>
+#include <unistd.h>
+#if defined(__linux__)
+# include <linux/perf_event.h>
+# include <sys/syscall.h>
+#endif
+
+static const char	*g_eventNames[PROFILER_EVENTS] =
+{
+	"cycles", "instructions", "cache-misses", "branch-misses"
+};
+
+static unsigned long		g_allocations = 0;
+static unsigned long		g_frees = 0;
+static unsigned long long	g_bytes = 0;
+
+/**
+ * @brief	Adds to a counter shared by every thread.
+ */
+template <typename T>
+static void	countAtomically(T &counter, T amount)
+{
+#if defined(__GNUC__)
+	__sync_fetch_and_add(&counter, amount);
+#else
+	counter += amount;
+#endif
+}
+
+/*
+ * Global allocation hooks: every operator new (and new[], which calls it)
+ * and every operator delete of the program is counted.
+ */
+void	*operator new(size_t size) throw(std::bad_alloc)
+{
+	countAtomically(g_allocations, 1UL);
+	countAtomically(g_bytes, static_cast<unsigned long long>(size));
+	void	*p = std::malloc(size != 0 ? size : 1);
+	if (p == NULL)
+		throw std::bad_alloc();
+	return (p);
+}
+
+void	operator delete(void *p) throw()
+{
+	if (p != NULL)
+		countAtomically(g_frees, 1UL);
+	std::free(p);
+}
+
+bool						Profiler::_enabled = false;
+int							Profiler::_fds[PROFILER_EVENTS] = {-1, -1, -1, -1};
+std::string					Profiler::_unavailable;
+std::vector<ProfileStats>	Profiler::_regions;
+
+/**
+ * @brief	Constructor for ProfileStats, with every total at 0.
+ */
+ProfileStats::ProfileStats(const std::string &name) : name(name), calls(0), wall(0),
+	allocations(0), frees(0), bytes(0)
+{
+	for (size_t i = 0; i < PROFILER_EVENTS; ++i)
+		events[i] = 0;
+}
+
+#if defined(__linux__)
+/**
+ * @brief	Opens one hardware counter on the calling process, user space
+ * 			only, inherited by the threads it starts afterwards.
+ *
+ * @return	The descriptor of the counter, or -1 with errno set.
+ */
+static int	openCounter(unsigned long long config)
+{
+	struct perf_event_attr	attr;
+
+	std::memset(&attr, 0, sizeof(attr));
+	attr.size = sizeof(attr);
+	attr.type = PERF_TYPE_HARDWARE;
+	attr.config = config;
+	attr.inherit = 1;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+	return (static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0)));
+}
+#endif
+
+/**
+ * @brief	Starts profiling: opens the hardware counters and lets regions
+ * 			record. Counters that cannot be opened are left out, and the
+ * 			reason of the first failure is kept for the report.
+ */
+void	Profiler::enable()
+{
+	if (_enabled)
+		return ;
+	_enabled = true;
+#if defined(__linux__)
+	static const unsigned long long	configs[PROFILER_EVENTS] =
+	{
+		PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+		PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES
+	};
+
+	for (size_t i = 0; i < PROFILER_EVENTS; ++i)
+	{
+		_fds[i] = openCounter(configs[i]);
+		if (_fds[i] < 0 && _unavailable.empty())
+			_unavailable = std::string("perf_event_open: ") + std::strerror(errno);
+	}
+#else
+	_unavailable = "no perf_event_open on this system";
+#endif
+}
+
+/**
+ * @brief	Whether enable was called.
+ */
+bool	Profiler::isEnabled()
+{
+	return (_enabled);
+}
+
+/**
+ * @brief	Reads the clock, the counters and the allocation totals.
+ */
+void	Profiler::sample(ProfileSample &sample)
+{
+	struct timespec	ts;
+
+	for (size_t i = 0; i < PROFILER_EVENTS; ++i)
+	{
+		unsigned long long	value = 0;
+
+		if (_fds[i] >= 0 && read(_fds[i], &value, sizeof(value)) != sizeof(value))
+			value = 0;
+		sample.events[i] = value;
+	}
+	sample.allocations = g_allocations;
+	sample.frees = g_frees;
+	sample.bytes = g_bytes;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	sample.wall = ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+/**
+ * @brief	Finds a region by name, creating it on first use.
+ *
+ * @return	The index of the region.
+ */
+size_t	Profiler::region(const char *name)
+{
+	for (size_t i = 0; i < _regions.size(); ++i)
+	{
+		if (_regions[i].name == name)
+			return (i);
+	}
+	_regions.push_back(ProfileStats(name));
+	return (_regions.size() - 1);
+}
+
+/**
+ * @brief	Adds one run of a region to its totals.
+ */
+void	Profiler::record(size_t region, const ProfileSample &start, const ProfileSample &end)
+{
+	ProfileStats	&stats = _regions[region];
+
+	stats.calls++;
+	stats.wall += end.wall - start.wall;
+	for (size_t i = 0; i < PROFILER_EVENTS; ++i)
+		stats.events[i] += end.events[i] - start.events[i];
+	stats.allocations += end.allocations - start.allocations;
+	stats.frees += end.frees - start.frees;
+	stats.bytes += end.bytes - start.bytes;
+}
+
+/**
+ * @brief	Writes one line per region, in order of first use: runs, wall
+ * 			time, the hardware counters with instructions per cycle, then
+ * 			allocations, releases and allocated bytes.
+ */
+void	Profiler::report(std::ostream &out)
+{
+	bool	counters = false;
+
+	if (!_enabled)
+		return ;
+	for (size_t i = 0; i < PROFILER_EVENTS; ++i)
+		counters = counters || _fds[i] >= 0;
+	out << "Profile:";
+	if (!counters)
+		out << " hardware counters unavailable (" << _unavailable << ")";
+	out << std::endl;
+	for (size_t r = 0; r < _regions.size(); ++r)
+	{
+		const ProfileStats	&stats = _regions[r];
+
+		out << "  " << stats.name << ": " << stats.calls << " runs, "
+			<< std::fixed << std::setprecision(1) << stats.wall << " us";
+		for (size_t i = 0; i < PROFILER_EVENTS; ++i)
+		{
+			if (_fds[i] >= 0)
+				out << ", " << stats.events[i] << " " << g_eventNames[i];
+		}
+		if (_fds[0] >= 0 && _fds[1] >= 0 && stats.events[0] > 0)
+			out << ", " << std::setprecision(2)
+				<< static_cast<double>(stats.events[1]) / stats.events[0] << " IPC";
+		out << ", " << stats.allocations << " allocations, " << stats.frees << " frees, "
+			<< stats.bytes << " bytes" << std::endl;
+		out.unsetf(std::ios::fixed);
+		out << std::setprecision(6);
+	}
+}
+
+/**
+ * @brief	Number of operator new calls since the program started.
+ */
+unsigned long	Profiler::allocations()
+{
+	return (g_allocations);
+}
+
+/**
+ * @brief	Number of operator delete calls on memory, since the program
+ * 			started.
+ */
+unsigned long	Profiler::frees()
+{
+	return (g_frees);
+}
+
+/**
+ * @brief	Bytes requested from operator new since the program started.
+ */
+unsigned long long	Profiler::allocatedBytes()
+{
+	return (g_bytes);
+}
+
+/**
+ * @brief	Constructor for ProfileRegion, starting a run of the region when
+ * 			profiling is enabled.
+ *
+ * @param	name The name of the region, as shown in the report.
+ */
+ProfileRegion::ProfileRegion(const char *name) : _region(0), _active(Profiler::isEnabled())
+{
+	if (!_active)
+		return ;
+	_region = Profiler::region(name);
+	Profiler::sample(_start);
+}
+
+/**
+ * @brief	Destructor for ProfileRegion, ending the run.
+ */
+ProfileRegion::~ProfileRegion()
+{
+	ProfileSample	end;
+
+	if (!_active)
+		return ;
+	Profiler::sample(end);
+	Profiler::record(_region, _start, end);
+}
@@ -0,0 +1,113 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   Profiler.hpp                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: benpicar <benpicar@student.42mulhouse.fr>  +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 18:42:15 by benpicar          #+#    #+#             */
+/*   Updated: 2026/10/19 18:42:15 by benpicar         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma once
+
+#ifndef PROFILER_HPP
+# define PROFILER_HPP
+
+# include <iostream>
+# include <string>
+# include <vector>
+
+/* Hardware events read by the profiler, in report order */
+# define PROFILER_EVENTS 4
+
+/**
+ * @brief	Snapshot of everything the profiler measures at one instant.
+ * 			A counter the host cannot read stays at 0.
+ */
+struct ProfileSample
+{
+	double				wall;
+	unsigned long long	events[PROFILER_EVENTS];
+	unsigned long		allocations;
+	unsigned long		frees;
+	unsigned long long	bytes;
+};
+
+/**
+ * @brief	Totals of one named region over all its runs.
+ */
+struct ProfileStats
+{
+	std::string			name;
+	unsigned long		calls;
+	double				wall;
+	unsigned long long	events[PROFILER_EVENTS];
+	unsigned long		allocations;
+	unsigned long		frees;
+	unsigned long long	bytes;
+
+	ProfileStats(const std::string &name);
+};
+
+/**
+ * @brief	Process-wide profiling layer shared by btc, RPN and PmergeMe.
+ * 			Linking it replaces the global operator new and delete, which
+ * 			count every allocation, its bytes and every release from then
+ * 			on. Once enabled, it also reads the cycles, instructions, cache
+ * 			misses and branch mispredictions of the process and of the
+ * 			threads it starts afterwards, through perf_event_open; on hosts
+ * 			without it, or where access is denied, those columns are simply
+ * 			reported as unavailable. Regions are marked with ProfileRegion,
+ * 			from the main thread only, and cost nothing until enabled.
+ */
+class Profiler
+{
+	private:
+		static bool						_enabled;
+		static int						_fds[PROFILER_EVENTS];
+		static std::string				_unavailable;
+		static std::vector<ProfileStats>	_regions;
+
+		Profiler();
+		Profiler(const Profiler &origin);
+		Profiler	&operator=(const Profiler &other);
+		~Profiler();
+
+	public:
+		static void				enable();
+		static bool				isEnabled();
+		static void				sample(ProfileSample &sample);
+		static size_t			region(const char *name);
+		static void				record(size_t region, const ProfileSample &start,
+									const ProfileSample &end);
+		static void				report(std::ostream &out);
+
+		static unsigned long		allocations();
+		static unsigned long		frees();
+		static unsigned long long	allocatedBytes();
+};
+
+/**
+ * @brief	Marks a named region for the lifetime of the object: what
+ * 			happens between its construction and destruction is added to
+ * 			the region's totals. Nested regions each count their whole
+ * 			extent.
+ */
+class ProfileRegion
+{
+	private:
+		size_t			_region;
+		bool			_active;
+		ProfileSample	_start;
+
+		ProfileRegion(const ProfileRegion &origin);
+		ProfileRegion	&operator=(const ProfileRegion &other);
+
+	public:
+		ProfileRegion(const char *name);
+		~ProfileRegion();
+};
+
+#endif
@@ -11,6 +11,29 @@
 /* ************************************************************************** */
 
 #include "BitcoinExchange.hpp"
+#include "Profiler.hpp"
+
+/**
+ * @brief	Default constructor for Batch, with room for BATCH_ROWS rows.
+ */
+BitcoinExchange::Batch::Batch() : size(0), dates(), days(BATCH_ROWS), amounts(BATCH_ROWS),
+	positions(BATCH_ROWS), rates(BATCH_ROWS), values(BATCH_ROWS),
+	valid((BATCH_ROWS + 63) / 64, 0), errors(), errorEnds(BATCH_ROWS)
+{
+	dates.reserve(BATCH_ROWS * 10);
+}
+
+/**
+ * @brief	Empties the batch, keeping its columns allocated.
+ */
+void	BitcoinExchange::Batch::clear()
+{
+	size = 0;
+	dates.clear();
+	valid.assign(valid.size(), 0);
+	errors.str("");
+	errors.clear();
+}
 
 /**
  * @brief	Default constructor for BitcoinExchange.
@@ -38,6 +61,8 @@ BitcoinExchange &BitcoinExchange::operator=(const BitcoinExchange &other)
 	if (this != &other)
 	{
 		_exchangeRates = other._exchangeRates;
+		_rateDays = other._rateDays;
+		_rateValues = other._rateValues;
 	}
 	return (*this);
 }
@@ -58,6 +83,7 @@ BitcoinExchange::~BitcoinExchange()
  */
 void	BitcoinExchange::loadExchangeRates(const char *filename)
 {
+	ProfileRegion	region("loadExchangeRates");
 	std::string		filenameStr(filename);
 	std::ifstream	file(filename);
 	std::string		line, date;
@@ -71,7 +97,7 @@ void	BitcoinExchange::loadExchangeRates(const char *filename)
 
 	while (std::getline(file, line))
 	{
-		if (!isValidFormInit(line))
+		if (!isValidFormInit(line, std::cerr))
 		{
 			continue;
 		}
@@ -84,6 +110,16 @@ void	BitcoinExchange::loadExchangeRates(const char *filename)
 		}
 		addExchangeRate(date, rate);
 	}
+	_rateDays.clear();
+	_rateValues.clear();
+	_rateDays.reserve(_exchangeRates.size());
+	_rateValues.reserve(_exchangeRates.size());
+	for (std::map<std::string, double>::const_iterator it = _exchangeRates.begin();
+		it != _exchangeRates.end(); ++it)
+	{
+		_rateDays.push_back(dayNumber(it->first));
+		_rateValues.push_back(it->second);
+	}
 }
 
 /**
@@ -133,16 +169,43 @@ bool	BitcoinExchange::isValidDate(const std::string &date)
 	return (true);
 }
 
+/**
+ * @brief	Number of the day of a valid date, counted from 1970-01-01:
+ * 			consecutive dates get consecutive numbers, so dates compare as
+ * 			their day numbers do.
+ *
+ * @param	date A date validated by isValidDate.
+ * @return	The day number, negative before 1970.
+ */
+long	BitcoinExchange::dayNumber(const std::string &date)
+{
+	long	year = (date[0] - '0') * 1000 + (date[1] - '0') * 100 + (date[2] - '0') * 10
+		+ (date[3] - '0');
+	long	month = (date[5] - '0') * 10 + (date[6] - '0');
+	long	day = (date[8] - '0') * 10 + (date[9] - '0');
+
+	// Years start in March, so the leap day ends them
+	if (month <= 2)
+		year--;
+	long	era = (year >= 0 ? year : year - 399) / 400;
+	long	yearOfEra = year - era * 400;
+	long	dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+	long	dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+
+	return (era * 146097 + dayOfEra - 719468);
+}
+
 /**
  * @brief	Validate the initial exchange rate format.
  * 			The rate must be a positive number, can contain a decimal point,
  * 			but cannot have more than one decimal point.
  * 
  * @param	rateStr The exchange rate string to validate.
+ * @param	err The stream the error found is written to.
  * @return	true if the rate is valid, false otherwise.
  * @throws	std::invalid_argument if the rate is negative
  */
-bool	BitcoinExchange::isValidRateInit(const std::string &rateStr)
+bool	BitcoinExchange::isValidRateInit(const std::string &rateStr, std::ostream &err)
 {
 	bool hasDecimalPoint = false;
 
@@ -153,7 +216,7 @@ bool	BitcoinExchange::isValidRateInit(const std::string &rateStr)
 	size_t i = 0;
 	if (rateStr[i] == '-')
 	{
-		std::cerr << "Error: not a positive number." << std::endl;
+		err << "Error: not a positive number." << std::endl;
 		return (false);
 	}
 	if (i >= rateStr.length())
@@ -167,7 +230,7 @@ bool	BitcoinExchange::isValidRateInit(const std::string &rateStr)
 		{
 			if (hasDecimalPoint)
 			{
-				std::cerr << "Error: more than one decimal point in rate." << std::endl;
+				err << "Error: more than one decimal point in rate." << std::endl;
 				return (false); // More than one decimal point
 			}
 			hasDecimalPoint = true;
@@ -175,7 +238,7 @@ bool	BitcoinExchange::isValidRateInit(const std::string &rateStr)
 		}
 		if (!isdigit(rateStr[i]))
 		{
-			std::cerr << "Error: non-digit character found in value." << std::endl;
+			err << "Error: non-digit character found in value." << std::endl;
 			return (false); // Non-digit character found
 		}
 	}
@@ -188,10 +251,11 @@ bool	BitcoinExchange::isValidRateInit(const std::string &rateStr)
  * 			but cannot have more than one decimal point, and must not exceed 1000.
  * 
  * @param	rateStr The exchange rate string to validate.
+ * @param	err The stream the error found is written to.
  * @return	true if the rate is valid, false otherwise.
  * @throws	std::invalid_argument if the rate is negative or exceeds 1000
  */
-bool	BitcoinExchange::isValidRate(const std::string &rateStr)
+bool	BitcoinExchange::isValidRate(const std::string &rateStr, std::ostream &err)
 {
 	bool hasDecimalPoint = false;
 
@@ -202,7 +266,7 @@ bool	BitcoinExchange::isValidRate(const std::string &rateStr)
 	size_t i = 0;
 	if (rateStr[i] == '-')
 	{
-		std::cerr << "Error: not a positive number." << std::endl;
+		err << "Error: not a positive number." << std::endl;
 		return (false);
 	}
 	if (i >= rateStr.length())
@@ -216,7 +280,7 @@ bool	BitcoinExchange::isValidRate(const std::string &rateStr)
 		{
 			if (hasDecimalPoint)
 			{
-				std::cerr << "Error: more than one decimal point in rate." << std::endl;
+				err << "Error: more than one decimal point in rate." << std::endl;
 				return (false); // More than one decimal point
 			}
 			hasDecimalPoint = true;
@@ -224,14 +288,14 @@ bool	BitcoinExchange::isValidRate(const std::string &rateStr)
 		}
 		if (!isdigit(rateStr[i]))
 		{
-			std::cerr << "Error: non-digit character found in value." << std::endl;
+			err << "Error: non-digit character found in value." << std::endl;
 			return (false); // Non-digit character found
 		}
 	}
 	double	rate = std::strtod(rateStr.c_str(), NULL);
 	if (rate > 1000)
 	{
-		std::cerr << "Error: too large a number." << std::endl;
+		err << "Error: too large a number." << std::endl;
 		return (false); // Rate exceeds maximum value
 	}
 	return (true);
@@ -243,9 +307,10 @@ bool	BitcoinExchange::isValidRate(const std::string &rateStr)
  * 			valid date and rate.
  * 
  * @param	line The line to validate.
+ * @param	err The stream the error found is written to.
  * @return	true if the line is valid, false otherwise.
  */
-bool	BitcoinExchange::isValidFormInit(const std::string &line)
+bool	BitcoinExchange::isValidFormInit(const std::string &line, std::ostream &err)
 {
 	size_t		pos = line.find(',');
 	
@@ -262,10 +327,10 @@ bool	BitcoinExchange::isValidFormInit(const std::string &line)
 	}
 	if (!isValidDate(date))
 	{
-		std::cerr << "Error: bad input => " << line << std::endl;
+		err << "Error: bad input => " << line << std::endl;
 		return (false);
 	}
-	if (!isValidRateInit(rateStr))
+	if (!isValidRateInit(rateStr, err))
 	{
 		return (false);
 	}
@@ -278,22 +343,27 @@ bool	BitcoinExchange::isValidFormInit(const std::string &line)
  * 			valid date and rate.
  * 
  * @param	line The line to validate.
+ * @param	firstLine Whether the header line may still come, and be skipped.
+ * @param	date Set to the trimmed date of the line.
+ * @param	rateStr Set to the trimmed value of the line.
+ * @param	err The stream the error found is written to.
  * @return	true if the line is valid, false otherwise.
  */
-bool	BitcoinExchange::isValidForm(const std::string &line, bool &firstLine)
+bool	BitcoinExchange::isValidForm(const std::string &line, bool &firstLine,
+	std::string &date, std::string &rateStr, std::ostream &err)
 {
 	size_t	pos = line.find('|');
 
 	if (pos == std::string::npos || pos < 10)
 	{
 		if (!firstLine)
-			std::cerr << "Error: bad input => " << line << std::endl;
+			err << "Error: bad input => " << line << std::endl;
 		else
 			firstLine = false;
 		return (false);
 	}
-	std::string date = line.substr(0, pos);
-	std::string rateStr = line.substr(pos + 1);
+	date.assign(line, 0, pos);
+	rateStr.assign(line, pos + 1, std::string::npos);
 
 	// Trim spaces around date and rateStr
 	date.erase(date.find_last_not_of(" \t") + 1);
@@ -308,12 +378,12 @@ bool	BitcoinExchange::isValidForm(const std::string &line, bool &firstLine)
 	if (!isValidDate(date))
 	{
 		if (!firstLine)
-			std::cerr << "Error: bad input => " << date << std::endl;
+			err << "Error: bad input => " << date << std::endl;
 		else
 			firstLine = false;
 		return (false);
 	}
-	if (!isValidRate(rateStr))
+	if (!isValidRate(rateStr, err))
 	{
 		return (false);
 	}
@@ -345,30 +415,153 @@ void	BitcoinExchange::addExchangeRate(const std::string &date, double rate)
 /**
  * @brief	Get the exchange rate for a specific date.
  * 			If the date does not exist, it will return the closest preceding
- * 			date's rate.
+ * 			date's rate. The lookup is a binary search on the same sorted
+ * 			day numbers as valueBatch, so both always agree.
  * 
  * @param	date The date for which the exchange rate is requested.
  * @return	The exchange rate for the specified date.
+ * @throws	std::invalid_argument if the date is not a valid YYYY-MM-DD date.
  * @throws	std::out_of_range if no exchange rate is found for the specified
  * 			date or any preceding date.
  */
 double	BitcoinExchange::getExchangeRate(const std::string &date) const
 {
-	std::map<std::string, double>::const_iterator it = _exchangeRates.find(date);
-	if (it != _exchangeRates.end())
+	if (!isValidDate(date))
+	{
+		throw std::invalid_argument("Invalid date: " + date);
+	}
+	std::vector<long>::const_iterator it = std::upper_bound(_rateDays.begin(), _rateDays.end(),
+		dayNumber(date));
+	if (it == _rateDays.begin())
+	{
+		throw std::out_of_range("Exchange rate for date " + date + " not found.");
+	}
+	// The last rate dated on or before the date
+	return (_rateValues[it - _rateDays.begin() - 1]);
+}
+
+/**
+ * @brief	Parses an input line into the next row of a batch. A line that
+ * 			is not valid, or dated before the first exchange rate, leaves
+ * 			its row unset in the validity bitmap, its error text being
+ * 			written to the batch for printBatch.
+ *
+ * @param	line The line to parse.
+ * @param	firstLine Whether the header line may still come, and be skipped.
+ * @param	batch The batch receiving the row.
+ */
+void	BitcoinExchange::parseRow(const std::string &line, bool &firstLine, Batch &batch) const
+{
+	size_t		row = batch.size++;
+	std::string	date, rateStr;
+	bool		valid = isValidForm(line, firstLine, date, rateStr, batch.errors);
+	long		day = 0;
+
+	if (valid)
+	{
+		day = dayNumber(date);
+		if (_rateDays.empty() || day < _rateDays[0])
+		{
+			batch.errors << "Exchange rate for date " << date << " not found." << std::endl;
+			valid = false;
+		}
+	}
+	if (valid)
 	{
-		return it->second;
+		batch.dates.append(date);
+		batch.amounts[row] = std::strtod(rateStr.c_str(), NULL);
+		batch.valid[row / 64] |= 1ULL << (row % 64);
 	}
 	else
 	{
-		it = _exchangeRates.lower_bound(date);
-		if (it == _exchangeRates.begin())
+		batch.dates.append(10, ' ');
+		batch.amounts[row] = 0;
+	}
+	batch.days[row] = day;
+	batch.errorEnds[row] = static_cast<size_t>(batch.errors.tellp());
+}
+
+/**
+ * @brief	Values every row of a batch, column by column. The position of
+ * 			each row's rate, the last dated on or before its day, is found
+ * 			by a branchless binary search run on all rows in lockstep: the
+ * 			probes of a step are independent, and the probe of the row a
+ * 			few places ahead is prefetched, so the loads of many searches
+ * 			overlap instead of each waiting for the previous one. The rates
+ * 			are then gathered and multiplied in straight loops the compiler
+ * 			can vectorize. Invalid rows go through the same loops, on
+ * 			whatever position they land, and are masked when printed.
+ *
+ * @param	batch The batch to value.
+ */
+void	BitcoinExchange::valueBatch(Batch &batch) const
+{
+	ProfileRegion	region("valueBatch");
+	size_t			n = batch.size;
+
+	if (n == 0 || _rateDays.empty())
+		return ;
+
+	const long	*rateDays = &_rateDays[0];
+	const long	*days = &batch.days[0];
+	size_t		*positions = &batch.positions[0];
+
+	for (size_t i = 0; i < n; ++i)
+		positions[i] = 0;
+	for (size_t length = _rateDays.size(); length > 1; length -= length / 2)
+	{
+		size_t	half = length / 2;
+
+		for (size_t i = 0; i < n; ++i)
+		{
+#if defined(__GNUC__)
+			if (i + RATE_PREFETCH_DISTANCE < n)
+				__builtin_prefetch(&rateDays[positions[i + RATE_PREFETCH_DISTANCE] + half]);
+#endif
+			positions[i] += half * (rateDays[positions[i] + half] <= days[i]);
+		}
+	}
+
+	const double	*rateValues = &_rateValues[0];
+	const double	*amounts = &batch.amounts[0];
+	double			*rates = &batch.rates[0];
+	double			*values = &batch.values[0];
+
+	for (size_t i = 0; i < n; ++i)
+		rates[i] = rateValues[positions[i]];
+	for (size_t i = 0; i < n; ++i)
+		values[i] = amounts[i] * rates[i];
+}
+
+/**
+ * @brief	Prints a valued batch in input order: the value of each valid
+ * 			row on the standard output, the error text of the others on the
+ * 			error output. Values are buffered, and only flushed before an
+ * 			error or at the end of the batch, so the two outputs interleave
+ * 			as if every line had been printed on its own.
+ *
+ * @param	batch The batch to print.
+ */
+void	BitcoinExchange::printBatch(Batch &batch)
+{
+	std::string	errors = batch.errors.str();
+	size_t		start = 0;
+
+	for (size_t i = 0; i < batch.size; ++i)
+	{
+		if (batch.valid[i / 64] & (1ULL << (i % 64)))
+		{
+			std::cout.write(batch.dates.data() + i * 10, 10);
+			std::cout << " => " << batch.amounts[i] << " = " << batch.values[i] << '\n';
+		}
+		else if (batch.errorEnds[i] > start)
 		{
-			throw std::out_of_range("Exchange rate for date " + date + " not found.");
+			std::cout.flush();
+			std::cerr.write(errors.data() + start, batch.errorEnds[i] - start);
 		}
-		--it; // Move to the previous date (the closest preceding date)
-		return (it->second);
+		start = batch.errorEnds[i];
 	}
+	std::cout.flush();
 }
 
 /**
@@ -377,11 +570,14 @@ double	BitcoinExchange::getExchangeRate(const std::string &date) const
  * 			in the format "YYYY-MM-DD | rate". It validates each line, retrieves
  * 			the exchange rate for the date, and prints the result in the format:
  * 			"YYYY-MM-DD => rate = exchangeRate".
+ * 			Lines are parsed into batches of BATCH_ROWS rows, each valued
+ * 			at once by valueBatch then printed in order by printBatch.
  * 
  * @param	filename The name of the file to process.
  */
 void	BitcoinExchange::processingFile(const char *filename) const
 {
+	ProfileRegion	region("processingFile");
 	std::ifstream	file(filename);
 	if (!file.is_open())
 	{
@@ -389,32 +585,18 @@ void	BitcoinExchange::processingFile(const char *filename) const
 	}
 	std::string	line;
 	bool		firstLine = true;
+	Batch		batch;
 
 	while (std::getline(file, line))
 	{
-		if (!isValidForm(line, firstLine))
-		{
-			continue;
-		}
-		size_t		pos = line.find('|');
-		std::string	date = line.substr(0, pos);
-		std::string	rateStr = line.substr(pos + 1);
-
-		// Trim spaces around date and rateStr
-		date.erase(date.find_last_not_of(" \t") + 1);
-		date.erase(0, date.find_first_not_of(" \t"));
-		rateStr.erase(rateStr.find_last_not_of(" \t") + 1);
-		rateStr.erase(0, rateStr.find_first_not_of(" \t"));
-
-		double rate = std::strtod(rateStr.c_str(), NULL);
-		try
-		{
-			double exchangeRate = getExchangeRate(date);
-			std::cout << date << " => " << rate << " = " << (rate * exchangeRate) << std::endl;
-		}
-		catch (const std::out_of_range &e)
+		parseRow(line, firstLine, batch);
+		if (batch.size == BATCH_ROWS)
 		{
-			std::cerr << e.what() << std::endl;
+			valueBatch(batch);
+			printBatch(batch);
+			batch.clear();
 		}
 	}
+	valueBatch(batch);
+	printBatch(batch);
 }
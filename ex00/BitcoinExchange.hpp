@@ -22,9 +22,17 @@
 # include <map>
 # include <stdexcept>
 # include <ctime>
+# include <vector>
+# include <algorithm>
 
 # define FILE_EXCHANGE "data.csv"
 
+/* Input lines parsed before a batch is valued and printed */
+# define BATCH_ROWS 4096
+
+/* Rows whose rate search is started ahead of the current one */
+# define RATE_PREFETCH_DISTANCE 16
+
 /**
  * @brief	Class to manage Bitcoin exchange rates.
  * 			This class provides functionality to load exchange rates from a file,
@@ -35,15 +43,45 @@
 class BitcoinExchange
 {
 	private:
-		std::map<std::string, double> _exchangeRates;
+		/**
+		 * @brief	Columns of up to BATCH_ROWS input lines, one row per line.
+		 * 			A row whose bit is set in valid is printed as a value;
+		 * 			any other row prints the error text it wrote, between
+		 * 			its predecessor's end in errorEnds and its own.
+		 */
+		struct Batch
+		{
+			size_t							size;
+			std::string						dates;
+			std::vector<long>				days;
+			std::vector<double>				amounts;
+			std::vector<size_t>				positions;
+			std::vector<double>				rates;
+			std::vector<double>				values;
+			std::vector<unsigned long long>	valid;
+			std::ostringstream				errors;
+			std::vector<size_t>				errorEnds;
+
+			Batch();
+			void	clear();
+		};
+
+		std::map<std::string, double>	_exchangeRates;
+		std::vector<long>				_rateDays;
+		std::vector<double>				_rateValues;
 
-		static bool		isValidFormInit(const std::string &line);
-		static bool		isValidForm(const std::string &line, bool &firstLine);
+		static bool		isValidFormInit(const std::string &line, std::ostream &err);
+		static bool		isValidForm(const std::string &line, bool &firstLine,
+							std::string &date, std::string &rateStr, std::ostream &err);
 		static bool		isValidDate(const std::string &date);
-		static bool		isValidRateInit(const std::string &rateStr);
-		static bool		isValidRate(const std::string &rateStr);
+		static bool		isValidRateInit(const std::string &rateStr, std::ostream &err);
+		static bool		isValidRate(const std::string &rateStr, std::ostream &err);
+		static long		dayNumber(const std::string &date);
 
 		void			addExchangeRate(const std::string &date, double rate);
+		void			parseRow(const std::string &line, bool &firstLine, Batch &batch) const;
+		void			valueBatch(Batch &batch) const;
+		static void		printBatch(Batch &batch);
 
 	public:
 		BitcoinExchange();
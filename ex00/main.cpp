@@ -11,17 +11,25 @@
 /* ************************************************************************** */
 
 #include "BitcoinExchange.hpp"
+#include "Profiler.hpp"
 
 int	main(int argc, char **argv)
 {
 	BitcoinExchange	bitcoinExchange;
+	int				first = 1;
 
-	if (argc != 2)
+	if (argc > first && std::string(argv[first]) == "--profile")
 	{
-		std::cerr << "Usage: " << argv[0] << " <input_file>" << std::endl;
+		Profiler::enable();
+		first++;
+	}
+	if (argc != first + 1)
+	{
+		std::cerr << "Usage: " << argv[0] << " [--profile] <input_file>" << std::endl;
 		return (1);
 	}
 	bitcoinExchange.loadExchangeRates(FILE_EXCHANGE);
-	bitcoinExchange.processingFile(argv[1]);
+	bitcoinExchange.processingFile(argv[first]);
+	Profiler::report(std::cerr);
 	return (0);
 }
@@ -0,0 +1,58 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   Arithmetic.hpp                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: benpicar <benpicar@student.42mulhouse.fr>  +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 12:38:26 by benpicar          #+#    #+#             */
+/*   Updated: 2026/10/19 12:39:10 by benpicar         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma once
+
+#ifndef ARITHMETIC_HPP
+# define ARITHMETIC_HPP
+
+# include "BigInt.hpp"
+# include "Rational.hpp"
+# include "Decimal.hpp"
+
+/**
+ * @brief	Operator kernels for the value types an RPN expression can be
+ * 			evaluated with. The four operations are the type's own operators;
+ * 			this only adds what they cannot express, so every instantiation
+ * 			of the evaluators inlines its own arithmetic.
+ * 
+ * @tparam	T BigInt, Rational, Decimal or double.
+ */
+template <typename T>
+struct Arithmetic
+{
+	static T	fromDigit(int digit)
+	{
+		return (T(digit));
+	}
+
+	static bool	isZero(const T &value)
+	{
+		return (value.isZero());
+	}
+};
+
+template <>
+struct Arithmetic<double>
+{
+	static double	fromDigit(int digit)
+	{
+		return (static_cast<double>(digit));
+	}
+
+	static bool		isZero(double value)
+	{
+		return (value == 0.0);
+	}
+};
+
+#endif
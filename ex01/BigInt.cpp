@@ -0,0 +1,570 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   BigInt.cpp                                         :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: benpicar <benpicar@student.42mulhouse.fr>  +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 12:30:44 by benpicar          #+#    #+#             */
+/*   Updated: 2026/10/19 12:39:10 by benpicar         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "BigInt.hpp"
+#include <sstream>
+
+/*
+ * Native overflow detection. GCC and Clang expose checked arithmetic as
+ * builtins that compile down to the plain instruction plus a flag test;
+ * other compilers fall back to portable range checks.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+# define ADD_OVERFLOW(a, b, res) __builtin_add_overflow(a, b, res)
+# define SUB_OVERFLOW(a, b, res) __builtin_sub_overflow(a, b, res)
+# define MUL_OVERFLOW(a, b, res) __builtin_mul_overflow(a, b, res)
+#else
+static bool	addOverflow(long long a, long long b, long long *res)
+{
+	if ((b > 0 && a > LLONG_MAX - b) || (b < 0 && a < LLONG_MIN - b))
+		return (true);
+	*res = a + b;
+	return (false);
+}
+
+static bool	subOverflow(long long a, long long b, long long *res)
+{
+	if ((b < 0 && a > LLONG_MAX + b) || (b > 0 && a < LLONG_MIN + b))
+		return (true);
+	*res = a - b;
+	return (false);
+}
+
+static bool	mulOverflow(long long a, long long b, long long *res)
+{
+	// Magnitudes are multiplied unsigned, after checking the product fits
+	unsigned long long	ua = (a < 0) ? 0ULL - static_cast<unsigned long long>(a) : a;
+	unsigned long long	ub = (b < 0) ? 0ULL - static_cast<unsigned long long>(b) : b;
+	bool				negative = (a < 0) != (b < 0);
+	unsigned long long	limit = static_cast<unsigned long long>(LLONG_MAX) + (negative ? 1 : 0);
+
+	if (ua != 0 && ub > limit / ua)
+		return (true);
+	unsigned long long	product = ua * ub;
+	if (!negative)
+		*res = static_cast<long long>(product);
+	else if (product == static_cast<unsigned long long>(LLONG_MAX) + 1)
+		*res = LLONG_MIN;
+	else
+		*res = -static_cast<long long>(product);
+	return (false);
+}
+# define ADD_OVERFLOW(a, b, res) addOverflow(a, b, res)
+# define SUB_OVERFLOW(a, b, res) subOverflow(a, b, res)
+# define MUL_OVERFLOW(a, b, res) mulOverflow(a, b, res)
+#endif
+
+/**
+ * @brief	Default constructor for BigInt, initialized to zero.
+ */
+BigInt::BigInt() : _isSmall(true), _small(0), _negative(false), _limbs()
+{}
+
+/**
+ * @brief	Constructor from a native integer.
+ * 
+ * @param	value The initial value.
+ */
+BigInt::BigInt(long long value) : _isSmall(true), _small(value), _negative(false), _limbs()
+{}
+
+/**
+ * @brief	Copy constructor for BigInt.
+ * 
+ * @param	origin The BigInt object to copy from.
+ */
+BigInt::BigInt(const BigInt &origin) : _isSmall(origin._isSmall), _small(origin._small),
+	_negative(origin._negative), _limbs(origin._limbs)
+{}
+
+/**
+ * @brief	Assignment operator for BigInt.
+ * 
+ * @param	other The BigInt object to assign from.
+ * @return	A reference to the current BigInt object.
+ */
+BigInt	&BigInt::operator=(const BigInt &other)
+{
+	if (this != &other)
+	{
+		_isSmall = other._isSmall;
+		_small = other._small;
+		_negative = other._negative;
+		_limbs = other._limbs;
+	}
+	return (*this);
+}
+
+/**
+ * @brief	Destructor for BigInt.
+ */
+BigInt::~BigInt()
+{}
+
+/**
+ * @brief	Remove the leading zero limbs of a magnitude.
+ * 
+ * @param	mag The magnitude to trim.
+ */
+void	BigInt::trim(std::vector<unsigned int> &mag)
+{
+	while (!mag.empty() && mag.back() == 0)
+	{
+		mag.pop_back();
+	}
+}
+
+/**
+ * @brief	Compare two magnitudes.
+ * 
+ * @return	-1, 0 or 1 if a is respectively lower, equal or greater than b.
+ */
+int	BigInt::compareMagnitude(const std::vector<unsigned int> &a,
+	const std::vector<unsigned int> &b)
+{
+	if (a.size() != b.size())
+		return (a.size() < b.size() ? -1 : 1);
+	for (size_t i = a.size(); i > 0; --i)
+	{
+		if (a[i - 1] != b[i - 1])
+			return (a[i - 1] < b[i - 1] ? -1 : 1);
+	}
+	return (0);
+}
+
+/**
+ * @brief	Add two magnitudes.
+ */
+void	BigInt::addMagnitude(std::vector<unsigned int> &res,
+	const std::vector<unsigned int> &a, const std::vector<unsigned int> &b)
+{
+	const std::vector<unsigned int>	&longest = (a.size() >= b.size()) ? a : b;
+	const std::vector<unsigned int>	&shortest = (a.size() >= b.size()) ? b : a;
+	unsigned long long				carry = 0;
+
+	res.assign(longest.size() + 1, 0);
+	for (size_t i = 0; i < longest.size(); ++i)
+	{
+		carry += longest[i];
+		if (i < shortest.size())
+			carry += shortest[i];
+		res[i] = static_cast<unsigned int>(carry);
+		carry >>= 32;
+	}
+	res[longest.size()] = static_cast<unsigned int>(carry);
+	trim(res);
+}
+
+/**
+ * @brief	Subtract two magnitudes, a must not be lower than b.
+ */
+void	BigInt::subMagnitude(std::vector<unsigned int> &res,
+	const std::vector<unsigned int> &a, const std::vector<unsigned int> &b)
+{
+	long long	borrow = 0;
+	long long	diff;
+
+	res.assign(a.size(), 0);
+	for (size_t i = 0; i < a.size(); ++i)
+	{
+		diff = static_cast<long long>(a[i]) - borrow;
+		if (i < b.size())
+			diff -= b[i];
+		borrow = 0;
+		if (diff < 0)
+		{
+			diff += 0x100000000LL;
+			borrow = 1;
+		}
+		res[i] = static_cast<unsigned int>(diff);
+	}
+	trim(res);
+}
+
+/**
+ * @brief	Multiply two magnitudes (schoolbook, which is linear when one of
+ * 			the operands is a single limb, the common case in RPN chains).
+ */
+void	BigInt::mulMagnitude(std::vector<unsigned int> &res,
+	const std::vector<unsigned int> &a, const std::vector<unsigned int> &b)
+{
+	unsigned long long	cur;
+
+	res.assign(a.size() + b.size(), 0);
+	for (size_t i = 0; i < a.size(); ++i)
+	{
+		unsigned long long	carry = 0;
+		for (size_t j = 0; j < b.size(); ++j)
+		{
+			cur = static_cast<unsigned long long>(a[i]) * b[j] + res[i + j] + carry;
+			res[i + j] = static_cast<unsigned int>(cur);
+			carry = cur >> 32;
+		}
+		res[i + b.size()] = static_cast<unsigned int>(carry);
+	}
+	trim(res);
+}
+
+/**
+ * @brief	Divide a magnitude in place by a single limb.
+ * 
+ * @return	The remainder of the division.
+ */
+unsigned int	BigInt::divSmallMagnitude(std::vector<unsigned int> &mag,
+	unsigned int divisor)
+{
+	unsigned long long	rem = 0;
+
+	for (size_t i = mag.size(); i > 0; --i)
+	{
+		rem = (rem << 32) | mag[i - 1];
+		mag[i - 1] = static_cast<unsigned int>(rem / divisor);
+		rem %= divisor;
+	}
+	trim(mag);
+	return (static_cast<unsigned int>(rem));
+}
+
+/**
+ * @brief	Divide two magnitudes, truncating the quotient. The divisor must
+ * 			not be zero.
+ */
+void	BigInt::divMagnitude(std::vector<unsigned int> &quot,
+	const std::vector<unsigned int> &a, const std::vector<unsigned int> &b)
+{
+	std::vector<unsigned int>	rem;
+	std::vector<unsigned int>	tmp;
+
+	if (b.size() == 1)
+	{
+		quot = a;
+		divSmallMagnitude(quot, b[0]);
+		return ;
+	}
+	quot.assign(a.size(), 0);
+	if (compareMagnitude(a, b) < 0)
+	{
+		trim(quot);
+		return ;
+	}
+	// Binary long division, only reached for multi-limb divisors
+	for (size_t bit = a.size() * 32; bit > 0; --bit)
+	{
+		unsigned int	carry = (a[(bit - 1) / 32] >> ((bit - 1) % 32)) & 1;
+		for (size_t i = 0; i < rem.size(); ++i)
+		{
+			unsigned int	next = rem[i] >> 31;
+			rem[i] = (rem[i] << 1) | carry;
+			carry = next;
+		}
+		if (carry)
+			rem.push_back(carry);
+		if (compareMagnitude(rem, b) >= 0)
+		{
+			subMagnitude(tmp, rem, b);
+			rem.swap(tmp);
+			quot[(bit - 1) / 32] |= 1u << ((bit - 1) % 32);
+		}
+	}
+	trim(quot);
+}
+
+/**
+ * @brief	Get the magnitude of the value, whatever its representation.
+ * 
+ * @param	mag Filled with the absolute value as base 2^32 limbs.
+ */
+void	BigInt::toMagnitude(std::vector<unsigned int> &mag) const
+{
+	if (!_isSmall)
+	{
+		mag = _limbs;
+		return ;
+	}
+	unsigned long long	abs = (_small < 0) ? 0ULL - static_cast<unsigned long long>(_small)
+		: static_cast<unsigned long long>(_small);
+	mag.clear();
+	mag.push_back(static_cast<unsigned int>(abs));
+	mag.push_back(static_cast<unsigned int>(abs >> 32));
+	trim(mag);
+}
+
+/**
+ * @brief	Check the sign of the value.
+ * 
+ * @return	true if the value is strictly negative.
+ */
+bool	BigInt::isNegative() const
+{
+	if (_isSmall)
+		return (_small < 0);
+	return (_negative);
+}
+
+/**
+ * @brief	Demote a wide value back to a native long long when it fits.
+ */
+void	BigInt::normalize()
+{
+	trim(_limbs);
+	if (_isSmall || _limbs.size() > 2)
+		return ;
+
+	unsigned long long	abs = 0;
+	if (_limbs.size() > 0)
+		abs = _limbs[0];
+	if (_limbs.size() > 1)
+		abs |= static_cast<unsigned long long>(_limbs[1]) << 32;
+
+	if (!_negative && abs <= static_cast<unsigned long long>(LLONG_MAX))
+		_small = static_cast<long long>(abs);
+	else if (_negative && abs <= static_cast<unsigned long long>(LLONG_MAX) + 1)
+		_small = (abs == static_cast<unsigned long long>(LLONG_MAX) + 1)
+			? LLONG_MIN : -static_cast<long long>(abs);
+	else
+		return ;
+	_isSmall = true;
+	_negative = false;
+	_limbs.clear();
+}
+
+/**
+ * @brief	Build a normalized BigInt from a sign and a magnitude.
+ */
+BigInt	BigInt::fromMagnitude(bool negative, const std::vector<unsigned int> &mag)
+{
+	BigInt	res;
+
+	res._isSmall = false;
+	res._negative = negative;
+	res._limbs = mag;
+	res.normalize();
+	return (res);
+}
+
+/**
+ * @brief	Wide addition (or subtraction when negateB is set).
+ */
+BigInt	BigInt::slowAdd(const BigInt &a, const BigInt &b, bool negateB)
+{
+	std::vector<unsigned int>	ma, mb, res;
+	bool						signA = a.isNegative();
+	bool						signB = b.isNegative() != negateB;
+
+	a.toMagnitude(ma);
+	b.toMagnitude(mb);
+	if (signA == signB)
+	{
+		addMagnitude(res, ma, mb);
+		return (fromMagnitude(signA, res));
+	}
+	if (compareMagnitude(ma, mb) >= 0)
+	{
+		subMagnitude(res, ma, mb);
+		return (fromMagnitude(signA, res));
+	}
+	subMagnitude(res, mb, ma);
+	return (fromMagnitude(signB, res));
+}
+
+/**
+ * @brief	Wide multiplication.
+ */
+BigInt	BigInt::slowMul(const BigInt &a, const BigInt &b)
+{
+	std::vector<unsigned int>	ma, mb, res;
+
+	a.toMagnitude(ma);
+	b.toMagnitude(mb);
+	mulMagnitude(res, ma, mb);
+	return (fromMagnitude(a.isNegative() != b.isNegative(), res));
+}
+
+/**
+ * @brief	Wide division, truncating toward zero like native integers.
+ */
+BigInt	BigInt::slowDiv(const BigInt &a, const BigInt &b)
+{
+	std::vector<unsigned int>	ma, mb, res;
+
+	a.toMagnitude(ma);
+	b.toMagnitude(mb);
+	divMagnitude(res, ma, mb);
+	return (fromMagnitude(a.isNegative() != b.isNegative(), res));
+}
+
+/**
+ * @brief	Addition, native unless the result overflows a long long.
+ */
+BigInt	BigInt::operator+(const BigInt &other) const
+{
+	long long	res;
+
+	if (_isSmall && other._isSmall && !ADD_OVERFLOW(_small, other._small, &res))
+		return (BigInt(res));
+	return (slowAdd(*this, other, false));
+}
+
+/**
+ * @brief	Subtraction, native unless the result overflows a long long.
+ */
+BigInt	BigInt::operator-(const BigInt &other) const
+{
+	long long	res;
+
+	if (_isSmall && other._isSmall && !SUB_OVERFLOW(_small, other._small, &res))
+		return (BigInt(res));
+	return (slowAdd(*this, other, true));
+}
+
+/**
+ * @brief	Multiplication, native unless the result overflows a long long.
+ */
+BigInt	BigInt::operator*(const BigInt &other) const
+{
+	long long	res;
+
+	if (_isSmall && other._isSmall && !MUL_OVERFLOW(_small, other._small, &res))
+		return (BigInt(res));
+	return (slowMul(*this, other));
+}
+
+/**
+ * @brief	Division truncating toward zero. LLONG_MIN / -1 is the only native
+ * 			overflow and goes through the wide path.
+ * 
+ * @throws	std::invalid_argument on division by zero.
+ */
+BigInt	BigInt::operator/(const BigInt &other) const
+{
+	if (other.isZero())
+		throw std::invalid_argument("Division by zero.");
+	if (_isSmall && other._isSmall && !(_small == LLONG_MIN && other._small == -1))
+		return (BigInt(_small / other._small));
+	return (slowDiv(*this, other));
+}
+
+/**
+ * @brief	Remainder of the truncating division, with the sign of the
+ * 			dividend like native integers.
+ * 
+ * @throws	std::invalid_argument on division by zero.
+ */
+BigInt	BigInt::operator%(const BigInt &other) const
+{
+	if (other.isZero())
+		throw std::invalid_argument("Division by zero.");
+	if (_isSmall && other._isSmall)
+		return (other._small == -1 ? BigInt(0) : BigInt(_small % other._small));
+	return (*this - (*this / other) * other);
+}
+
+/**
+ * @brief	Negation, LLONG_MIN being the only value promoted.
+ */
+BigInt	BigInt::operator-() const
+{
+	return (BigInt(0) - *this);
+}
+
+/**
+ * @brief	Equality, relying on values always being normalized.
+ */
+bool	BigInt::operator==(const BigInt &other) const
+{
+	if (_isSmall != other._isSmall)
+		return (false);
+	if (_isSmall)
+		return (_small == other._small);
+	return (_negative == other._negative && _limbs == other._limbs);
+}
+
+bool	BigInt::operator!=(const BigInt &other) const
+{
+	return (!(*this == other));
+}
+
+/**
+ * @brief	Check if the value is zero.
+ */
+bool	BigInt::isZero() const
+{
+	return (_isSmall && _small == 0);
+}
+
+/**
+ * @brief	Check if the value is currently held as a native long long.
+ */
+bool	BigInt::isSmall() const
+{
+	return (_isSmall);
+}
+
+/**
+ * @brief	Convert the value to its decimal representation.
+ * 
+ * @return	The decimal string, with a leading '-' for negative values.
+ */
+std::string	BigInt::toString() const
+{
+	if (_isSmall)
+	{
+		std::ostringstream	oss;
+		oss << _small;
+		return (oss.str());
+	}
+
+	std::vector<unsigned int>	mag(_limbs);
+	std::vector<unsigned int>	chunks;
+	std::ostringstream			oss;
+
+	while (!mag.empty())
+	{
+		chunks.push_back(divSmallMagnitude(mag, 1000000000u));
+	}
+	if (_negative)
+		oss << '-';
+	oss << chunks.back();
+	for (size_t i = chunks.size() - 1; i > 0; --i)
+	{
+		std::ostringstream	digits;
+		digits << chunks[i - 1];
+		std::string			part = digits.str();
+		oss << std::string(9 - part.length(), '0') << part;
+	}
+	return (oss.str());
+}
+
+/**
+ * @brief	Greatest common divisor (Euclid), always non-negative.
+ */
+BigInt	gcd(BigInt a, BigInt b)
+{
+	BigInt	tmp;
+
+	while (!b.isZero())
+	{
+		tmp = a % b;
+		a = b;
+		b = tmp;
+	}
+	return (a.isNegative() ? -a : a);
+}
+
+/**
+ * @brief	Output stream operator for BigInt.
+ */
+std::ostream	&operator<<(std::ostream &os, const BigInt &value)
+{
+	os << value.toString();
+	return (os);
+}
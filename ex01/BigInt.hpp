@@ -0,0 +1,92 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   BigInt.hpp                                         :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: benpicar <benpicar@student.42mulhouse.fr>  +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 12:30:03 by benpicar          #+#    #+#             */
+/*   Updated: 2026/10/19 12:39:10 by benpicar         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma once
+
+#ifndef BIGINT_HPP
+# define BIGINT_HPP
+
+# include <iostream>
+# include <string>
+# include <vector>
+# include <climits>
+# include <stdexcept>
+
+/**
+ * @brief	Signed integer that stays on native 64-bit arithmetic as long as
+ * 			the result fits in a long long, and transparently promotes to an
+ * 			arbitrary-precision magnitude (base 2^32 limbs) on overflow.
+ * 			Results that fit back in a long long are demoted again, so the
+ * 			slow path is only paid while values are actually large.
+ */
+class BigInt
+{
+	private:
+		bool						_isSmall;
+		long long					_small;
+		bool						_negative;
+		std::vector<unsigned int>	_limbs;
+
+		static int		compareMagnitude(const std::vector<unsigned int> &a,
+							const std::vector<unsigned int> &b);
+		static void		addMagnitude(std::vector<unsigned int> &res,
+							const std::vector<unsigned int> &a,
+							const std::vector<unsigned int> &b);
+		static void		subMagnitude(std::vector<unsigned int> &res,
+							const std::vector<unsigned int> &a,
+							const std::vector<unsigned int> &b);
+		static void		mulMagnitude(std::vector<unsigned int> &res,
+							const std::vector<unsigned int> &a,
+							const std::vector<unsigned int> &b);
+		static void		divMagnitude(std::vector<unsigned int> &quot,
+							const std::vector<unsigned int> &a,
+							const std::vector<unsigned int> &b);
+		static unsigned int	divSmallMagnitude(std::vector<unsigned int> &mag,
+							unsigned int divisor);
+		static void		trim(std::vector<unsigned int> &mag);
+
+		void			toMagnitude(std::vector<unsigned int> &mag) const;
+		void			normalize();
+
+		static BigInt	fromMagnitude(bool negative,
+							const std::vector<unsigned int> &mag);
+		static BigInt	slowAdd(const BigInt &a, const BigInt &b, bool negateB);
+		static BigInt	slowMul(const BigInt &a, const BigInt &b);
+		static BigInt	slowDiv(const BigInt &a, const BigInt &b);
+
+	public:
+		BigInt();
+		BigInt(long long value);
+		BigInt(const BigInt &origin);
+		BigInt		&operator=(const BigInt &other);
+		~BigInt();
+
+		BigInt		operator+(const BigInt &other) const;
+		BigInt		operator-(const BigInt &other) const;
+		BigInt		operator*(const BigInt &other) const;
+		BigInt		operator/(const BigInt &other) const;
+		BigInt		operator%(const BigInt &other) const;
+		BigInt		operator-() const;
+
+		bool		operator==(const BigInt &other) const;
+		bool		operator!=(const BigInt &other) const;
+
+		bool		isZero() const;
+		bool		isNegative() const;
+		bool		isSmall() const;
+		std::string	toString() const;
+};
+
+BigInt			gcd(BigInt a, BigInt b);
+std::ostream	&operator<<(std::ostream &os, const BigInt &value);
+
+#endif
@@ -0,0 +1,153 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   Decimal.cpp                                        :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: benpicar <benpicar@student.42mulhouse.fr>  +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 12:38:10 by benpicar          #+#    #+#             */
+/*   Updated: 2026/10/19 12:39:10 by benpicar         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "Decimal.hpp"
+
+/**
+ * @brief	Default constructor for Decimal, initialized to zero.
+ */
+Decimal::Decimal() : _units(0)
+{}
+
+/**
+ * @brief	Constructor from an integer.
+ * 
+ * @param	value The initial value.
+ */
+Decimal::Decimal(long long value) : _units(BigInt(value) * scale())
+{}
+
+/**
+ * @brief	Copy constructor for Decimal.
+ * 
+ * @param	origin The Decimal object to copy from.
+ */
+Decimal::Decimal(const Decimal &origin) : _units(origin._units)
+{}
+
+/**
+ * @brief	Assignment operator for Decimal.
+ * 
+ * @param	other The Decimal object to assign from.
+ * @return	A reference to the current Decimal object.
+ */
+Decimal	&Decimal::operator=(const Decimal &other)
+{
+	if (this != &other)
+	{
+		_units = other._units;
+	}
+	return (*this);
+}
+
+/**
+ * @brief	Destructor for Decimal.
+ */
+Decimal::~Decimal()
+{}
+
+/**
+ * @brief	Compute 10^DECIMAL_SCALE.
+ */
+static BigInt	powerOfTen()
+{
+	BigInt	value(1);
+
+	for (int i = 0; i < DECIMAL_SCALE; ++i)
+		value = value * BigInt(10);
+	return (value);
+}
+
+/*
+ * Built before main, so worker threads of a parallel evaluation only ever
+ * read it.
+ */
+static const BigInt	g_scale = powerOfTen();
+
+/**
+ * @brief	Get 10^DECIMAL_SCALE, the number of units in 1.
+ */
+BigInt const	&Decimal::scale()
+{
+	return (g_scale);
+}
+
+Decimal	Decimal::operator+(const Decimal &other) const
+{
+	Decimal	res;
+
+	res._units = _units + other._units;
+	return (res);
+}
+
+Decimal	Decimal::operator-(const Decimal &other) const
+{
+	Decimal	res;
+
+	res._units = _units - other._units;
+	return (res);
+}
+
+Decimal	Decimal::operator*(const Decimal &other) const
+{
+	Decimal	res;
+
+	res._units = (_units * other._units) / scale();
+	return (res);
+}
+
+/**
+ * @throws	std::invalid_argument on division by zero.
+ */
+Decimal	Decimal::operator/(const Decimal &other) const
+{
+	Decimal	res;
+
+	res._units = (_units * scale()) / other._units;
+	return (res);
+}
+
+/**
+ * @brief	Check if the value is zero.
+ */
+bool	Decimal::isZero() const
+{
+	return (_units.isZero());
+}
+
+/**
+ * @brief	Convert the value to its decimal representation, without
+ * 			trailing fractional zeros.
+ */
+std::string	Decimal::toString() const
+{
+	BigInt		abs = _units.isNegative() ? -_units : _units;
+	std::string	integer = (abs / scale()).toString();
+	std::string	fraction = (abs % scale()).toString();
+	std::string	res = _units.isNegative() ? "-" : "";
+
+	res += integer;
+	fraction.insert(0, DECIMAL_SCALE - fraction.length(), '0');
+	fraction.erase(fraction.find_last_not_of('0') + 1);
+	if (!fraction.empty())
+		res += "." + fraction;
+	return (res);
+}
+
+/**
+ * @brief	Output stream operator for Decimal.
+ */
+std::ostream	&operator<<(std::ostream &os, const Decimal &value)
+{
+	os << value.toString();
+	return (os);
+}
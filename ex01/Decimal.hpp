@@ -0,0 +1,55 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   Decimal.hpp                                        :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: benpicar <benpicar@student.42mulhouse.fr>  +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 12:38:10 by benpicar          #+#    #+#             */
+/*   Updated: 2026/10/19 12:39:10 by benpicar         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma once
+
+#ifndef DECIMAL_HPP
+# define DECIMAL_HPP
+
+# include <iostream>
+# include <string>
+# include "BigInt.hpp"
+
+/* Number of fractional digits kept by Decimal */
+# define DECIMAL_SCALE 9
+
+/**
+ * @brief	Fixed-point decimal number, stored as a BigInt count of
+ * 			10^-DECIMAL_SCALE units. Products and quotients are truncated
+ * 			toward zero to the scale, like integer division.
+ */
+class Decimal
+{
+	private:
+		BigInt	_units;
+
+		static BigInt const	&scale();
+
+	public:
+		Decimal();
+		Decimal(long long value);
+		Decimal(const Decimal &origin);
+		Decimal		&operator=(const Decimal &other);
+		~Decimal();
+
+		Decimal		operator+(const Decimal &other) const;
+		Decimal		operator-(const Decimal &other) const;
+		Decimal		operator*(const Decimal &other) const;
+		Decimal		operator/(const Decimal &other) const;
+
+		bool		isZero() const;
+		std::string	toString() const;
+};
+
+std::ostream	&operator<<(std::ostream &os, const Decimal &value);
+
+#endif
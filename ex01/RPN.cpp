@@ -6,24 +6,32 @@
 /*   By: benpicar <benpicar@student.42mulhouse.fr>  +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/06/20 15:38:29 by benpicar          #+#    #+#             */
-/*   Updated: 2025/06/24 18:01:51 by benpicar         ###   ########.fr       */
+/*   Updated: 2026/10/19 12:40:40 by benpicar         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "RPN.hpp"
+#include "Profiler.hpp"
 
 /**
  * @brief	Default constructor for RPN.
  */
-RPN::RPN() : _stack()
-{}
+RPN::RPN() : _program(), _cache(), _native(), _strategy(COMPILED), _type(INTEGER), _threads(1)
+{
+	long	cpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+	if (cpus > 1)
+		_threads = static_cast<unsigned int>(cpus);
+}
 
 /**
  * @brief	Copy constructor for RPN.
  * 
  * @param	origin The RPN object to copy from.
  */
-RPN::RPN(const RPN &origin) : _stack(origin._stack)
+RPN::RPN(const RPN &origin) : _program(origin._program), _cache(origin._cache),
+	_native(origin._native), _strategy(origin._strategy),
+	_type(origin._type), _threads(origin._threads)
 {}
 
 /**
@@ -36,7 +44,12 @@ RPN	&RPN::operator=(const RPN &other)
 {
 	if (this != &other)
 	{
-		_stack = other._stack;
+		_program = other._program;
+		_cache = other._cache;
+		_native = other._native;
+		_strategy = other._strategy;
+		_type = other._type;
+		_threads = other._threads;
 	}
 	return (*this);
 }
@@ -48,7 +61,64 @@ RPN::~RPN()
 {}
 
 /**
- * @brief	Evaluate a Reverse Polish Notation (RPN) expression.
+ * @brief	Select how expressions are evaluated.
+ * 			COMPILED (the default) validates the whole expression into an
+ * 			RPNProgram before running it; STACK streams the tokens through
+ * 			performOperation and is kept as the reference implementation.
+ * 			NATIVE runs integer programs as machine code (see RPNNative),
+ * 			without the cache, and is COMPILED for the other value types.
+ * 
+ * @param	strategy The evaluation strategy to use.
+ */
+void	RPN::setStrategy(Strategy strategy)
+{
+	_strategy = strategy;
+}
+
+/**
+ * @brief	Set how many threads the compiled evaluation may use. Only very
+ * 			large expressions are actually split (see PARALLEL_MIN_WIDTH).
+ * 			Defaults to the number of online processors.
+ * 
+ * @param	threads The maximum number of threads, 0 being treated as 1.
+ */
+void	RPN::setThreads(unsigned int threads)
+{
+	_threads = (threads == 0) ? 1 : threads;
+}
+
+/**
+ * @brief	Select the value type expressions are evaluated with.
+ * 
+ * @param	type INTEGER (exact, the default), FLOATING, RATIONAL or DECIMAL.
+ */
+void	RPN::setValueType(ValueType type)
+{
+	_type = type;
+}
+
+/**
+ * @brief	Set the size of the memoization cache of the compiled
+ * 			evaluation (see RPNCache). The cache is disabled by default.
+ * 
+ * @param	bytes The capacity in bytes, 0 disabling the cache.
+ */
+void	RPN::setCacheSize(size_t bytes)
+{
+	_cache.setCapacity(bytes);
+}
+
+/**
+ * @brief	Get the memoization cache, for its counters.
+ */
+RPNCache const	&RPN::getCache() const
+{
+	return (_cache);
+}
+
+/**
+ * @brief	Evaluate a Reverse Polish Notation (RPN) expression and print
+ * 			its result.
  * 
  * @param	expressions An array of strings representing the RPN expressions.
  * @param	length The number of expressions in the array.
@@ -57,24 +127,258 @@ RPN::~RPN()
  * @throws	TooManyOperands if there are more than one result left in the stack
  */
 void	RPN::evaluateExpression(char **expressions, int length)
+{
+	std::cout << evaluateToString(expressions, length) << std::endl;
+}
+
+/**
+ * @brief	Evaluate a Reverse Polish Notation (RPN) expression.
+ * 
+ * @param	expressions An array of strings representing the RPN expressions.
+ * @param	length The number of expressions in the array.
+ * @return	The result, formatted as evaluateExpression prints it.
+ * @throws	std::invalid_argument if the expressions array is null or empty,
+ * 			or if an expression is invalid.
+ * @throws	TooManyOperands if there are more than one result left in the stack
+ */
+std::string	RPN::evaluateToString(char **expressions, int length)
 {
 	if (!expressions || length <= 0)
 	{
 		throw std::invalid_argument("Invalid expressions input.");
 	}
+	switch (_type)
+	{
+		case (FLOATING):
+			return (evaluate<double>(expressions, length));
+		case (RATIONAL):
+			return (evaluate<Rational>(expressions, length));
+		case (DECIMAL):
+			return (evaluate<Decimal>(expressions, length));
+		default:
+			return (evaluate<BigInt>(expressions, length));
+	}
+}
+
+/**
+ * @brief	Evaluate expressions with a given value type.
+ * 
+ * @tparam	T The value type: BigInt, Rational, Decimal or double.
+ * @param	expressions An array of strings representing the RPN expressions.
+ * @param	length The number of expressions in the array.
+ * @return	The formatted result.
+ */
+template <typename T>
+std::string	RPN::evaluate(char **expressions, int length)
+{
+	std::ostringstream	oss;
+	std::stack<T>		stack;
+
+	if (_strategy == NATIVE && _type == INTEGER)
+		return (evaluateNative(expressions, length));
+	if (_strategy != STACK && _cache.getCapacity() > 0)
+		return (evaluateCached<T>(expressions, length));
+	if (_strategy != STACK)
+	{
+		{
+			ProfileRegion	region("compile");
+			_program.compile(expressions, length, _type == FLOATING);
+		}
+		ProfileRegion	region("execute");
+		oss << _program.execute<T>(_threads);
+		return (oss.str());
+	}
+
+	ProfileRegion	region("performOperation");
 	for (int i = 0; i < length; ++i)
 	{
 		if (!expressions[i] || !*expressions[i])
 		{
 			continue ;
 		}
-		performOperation(expressions[i]);
+		performOperation(expressions[i], stack);
 	}
-	if (this->_stack.size() != 1)
+	if (stack.size() != 1)
 	{
 		throw (TooManyOperands());
 	}
-	std::cout << this->_stack.top() << std::endl;
+	oss << stack.top();
+	return (oss.str());
+}
+
+/**
+ * @brief	Evaluate expressions through the memoization cache. An outcome
+ * 			already known for the value type is replayed without running
+ * 			anything; an expression cached for another value type reuses
+ * 			its compiled program, unless only one of the two types has
+ * 			signed zeros (see RPNProgram::reduce); otherwise it is compiled
+ * 			and cached. The outcome is stored in every case, errors included.
+ * 
+ * @tparam	T The value type: BigInt, Rational, Decimal or double.
+ * @param	expressions An array of strings representing the RPN expressions.
+ * @param	length The number of expressions in the array.
+ * @return	The formatted result.
+ */
+template <typename T>
+std::string	RPN::evaluateCached(char **expressions, int length)
+{
+	std::string			key = RPNCache::normalize(expressions, length);
+	size_t				index = _cache.find(key);
+	RPNCache::Result	result;
+
+	if (index != RPNCache::npos && _cache.getEntry(index).results[_type].outcome != RPNCache::UNKNOWN)
+	{
+		_cache.countHit();
+		return (replay(_cache.getEntry(index).results[_type]));
+	}
+	_cache.countMiss();
+	bool	shared = index != RPNCache::npos
+		&& _cache.getEntry(index).program.keepsSignedZeros() == (_type == FLOATING);
+	if (!shared)
+	{
+		{
+			ProfileRegion	region("compile");
+			_program.compile(expressions, length, _type == FLOATING);
+		}
+		if (index == RPNCache::npos)
+		{
+			index = _cache.insert(key, _program);
+			shared = index != RPNCache::npos;
+		}
+	}
+
+	ProfileRegion	region("execute");
+	result = run<T>(shared ? _cache.getEntry(index).program : _program, _threads);
+	if (index != RPNCache::npos)
+		_cache.store(index, _type, result);
+	return (replay(result));
+}
+
+/**
+ * @brief	Evaluate integer expressions as native code. The machine code
+ * 			computes on long long: its result and its division by zero are
+ * 			those of the expression, but on overflow, or when no code could
+ * 			be made, the program is run by the exact interpreter instead.
+ * 
+ * @param	expressions An array of strings representing the RPN expressions.
+ * @param	length The number of expressions in the array.
+ * @return	The formatted result.
+ */
+std::string	RPN::evaluateNative(char **expressions, int length)
+{
+	std::ostringstream	oss;
+	bool				compiled;
+	long long			value;
+
+	{
+		ProfileRegion	region("compile");
+		_program.compile(expressions, length);
+		compiled = _native.compile(_program);
+	}
+	if (compiled)
+	{
+		ProfileRegion	region("execute native");
+		switch (_native.run(value))
+		{
+			case (RPNNative::DONE):
+				oss << value;
+				return (oss.str());
+			case (RPNNative::DIVISION_BY_ZERO):
+				throw std::invalid_argument("Division by zero.");
+			case (RPNNative::OVERFLOWED):
+				break ;
+		}
+	}
+	ProfileRegion	region("execute");
+	oss << _program.execute<BigInt>(_threads);
+	return (oss.str());
+}
+
+/**
+ * @brief	Run a compiled program, turning the errors an expression can
+ * 			raise into an outcome. Other failures, such as running out of
+ * 			memory, are not outcomes of the expression and propagate.
+ */
+template <typename T>
+RPNCache::Result	RPN::run(const RPNProgram &program, unsigned int threads)
+{
+	RPNCache::Result	result;
+	std::ostringstream	oss;
+
+	try
+	{
+		oss << program.execute<T>(threads);
+		result.outcome = RPNCache::VALUE;
+		result.text = oss.str();
+	}
+	catch (const std::invalid_argument &e)
+	{
+		result.outcome = RPNCache::INVALID_ARGUMENT;
+		result.text = e.what();
+	}
+	catch (const NotEnoughOperands &)
+	{
+		result.outcome = RPNCache::NOT_ENOUGH_OPERANDS;
+	}
+	catch (const TooManyOperands &)
+	{
+		result.outcome = RPNCache::TOO_MANY_OPERANDS;
+	}
+	return (result);
+}
+
+/**
+ * @brief	Give back an outcome as evaluation would: return the result,
+ * 			or throw the same exception again.
+ */
+std::string	RPN::replay(const RPNCache::Result &result)
+{
+	switch (result.outcome)
+	{
+		case (RPNCache::INVALID_ARGUMENT):
+			throw std::invalid_argument(result.text);
+		case (RPNCache::NOT_ENOUGH_OPERANDS):
+			throw (NotEnoughOperands());
+		case (RPNCache::TOO_MANY_OPERANDS):
+			throw (TooManyOperands());
+		default:
+			return (result.text);
+	}
+}
+
+/**
+ * @brief	Evaluate one expression per line of a stream and write one line
+ * 			per expression: the result, or the error as evaluateExpression
+ * 			reports it.
+ * 
+ * @param	in The stream of expressions.
+ * @param	out The stream receiving the results.
+ * @return	The number of expressions that failed.
+ */
+size_t	RPN::evaluateStream(std::istream &in, std::ostream &out)
+{
+	std::string			line;
+	std::vector<char>	buffer;
+	char				*expressions[1];
+	size_t				failures = 0;
+
+	while (std::getline(in, line))
+	{
+		buffer.assign(line.begin(), line.end());
+		buffer.push_back('\0');
+		expressions[0] = &buffer[0];
+		try
+		{
+			out << evaluateToString(expressions, 1) << '\n';
+		}
+		catch (const std::exception &e)
+		{
+			out << "Error: " << e.what() << '\n';
+			failures++;
+		}
+	}
+	out.flush();
+	return (failures);
 }
 
 /**
@@ -95,15 +399,17 @@ void	RPN::nextInfo(std::string &expression, size_t &idx)
  * @brief	Perform operations based on the RPN expression.
  * 
  * @param	expression The RPN expression string to evaluate.
+ * @param	stack The operand stack, shared by all the expressions.
  * @throws	std::invalid_argument if the expression is empty, contains invalid
  * 			characters, or if there are not enough operands for an operation.
  * @throws	NotEnoughOperands if there are not enough operands for an operation.
  */
-void	RPN::performOperation(char *expression)
+template <typename T>
+void	RPN::performOperation(char *expression, std::stack<T> &stack)
 {
 	size_t		idx = 0;
 	char		token;
-	long long	a, b;
+	T			a, b;
 
 	if (!expression || !*expression)
 	{
@@ -126,31 +432,31 @@ void	RPN::performOperation(char *expression)
 		}
 		if (isdigit(token))
 		{
-			this->_stack.push(static_cast<long long>(token - '0'));
+			stack.push(Arithmetic<T>::fromDigit(token - '0'));
 		}
 		else if (token == '+' || token == '-' || token == '*' || token == '/')
 		{
-			if (this->_stack.size() < 2)
+			if (stack.size() < 2)
 				throw (NotEnoughOperands());
-			b = this->_stack.top();
-			this->_stack.pop();
-			a = this->_stack.top();
-			this->_stack.pop();
+			b = stack.top();
+			stack.pop();
+			a = stack.top();
+			stack.pop();
 			switch (token)
 			{
 				case ('+'):
-					this->_stack.push(a + b);
+					stack.push(a + b);
 					break ;
 				case ('-'):
-					this->_stack.push(a - b);
+					stack.push(a - b);
 					break ;
 				case ('*'):
-					this->_stack.push(a * b);
+					stack.push(a * b);
 					break ;
 				case ('/'):
-					if (b == 0)
+					if (Arithmetic<T>::isZero(b))
 						throw std::invalid_argument("Division by zero.");
-					this->_stack.push(a / b);
+					stack.push(a / b);
 					break ;
 				default:
 					throw std::invalid_argument("Unknown operator.");
@@ -6,7 +6,7 @@
 /*   By: benpicar <benpicar@student.42mulhouse.fr>  +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/06/20 14:56:12 by benpicar          #+#    #+#             */
-/*   Updated: 2025/06/24 17:05:01 by benpicar         ###   ########.fr       */
+/*   Updated: 2026/10/19 12:40:40 by benpicar         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -19,20 +19,58 @@
 # include <stack>
 # include <sstream>
 # include <stdexcept>
+# include <cstdlib>
 # include <cctype>
+# include <unistd.h>
+# include "BigInt.hpp"
+# include "RPNProgram.hpp"
+# include "RPNCache.hpp"
+# include "RPNNative.hpp"
 
 /**
  * @brief	Class to evaluate Reverse Polish Notation (RPN) expressions.
  *			This class provides functionality to evaluate RPN expressions using
- * 			a stack.
+ * 			a stack. The value type is chosen at runtime among exact integers
+ * 			(BigInt, the default), double, exact fractions and fixed-point
+ * 			decimals; each one has its own instantiation of the evaluators.
  */
 class RPN
 {
+	public:
+		enum Strategy
+		{
+			STACK,
+			COMPILED,
+			NATIVE
+		};
+
+		enum ValueType
+		{
+			INTEGER,
+			FLOATING,
+			RATIONAL,
+			DECIMAL
+		};
+
 	private:
-		std::stack<long long>	_stack;
+		RPNProgram				_program;
+		RPNCache				_cache;
+		RPNNative				_native;
+		Strategy				_strategy;
+		ValueType				_type;
+		unsigned int			_threads;
 
 		void		nextInfo(std::string &expression, size_t &idx);
-		void		performOperation(char *expression);
+		template <typename T>
+		void		performOperation(char *expression, std::stack<T> &stack);
+		template <typename T>
+		std::string	evaluate(char **expressions, int length);
+		template <typename T>
+		std::string	evaluateCached(char **expressions, int length);
+		std::string	evaluateNative(char **expressions, int length);
+		template <typename T>
+		static RPNCache::Result	run(const RPNProgram &program, unsigned int threads);
+		static std::string		replay(const RPNCache::Result &result);
 
 	public:
 		RPN();
@@ -40,7 +78,15 @@ class RPN
 		RPN			&operator=(const RPN &other);
 		~RPN();
 
+		void		setStrategy(Strategy strategy);
+		void		setThreads(unsigned int threads);
+		void		setValueType(ValueType type);
+		void		setCacheSize(size_t bytes);
 		void		evaluateExpression(char **expressions, int length);
+		std::string	evaluateToString(char **expressions, int length);
+		size_t		evaluateStream(std::istream &in, std::ostream &out);
+
+		RPNCache const	&getCache() const;
 
 		class TooManyOperands : public std::exception
 		{
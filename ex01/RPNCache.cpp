@@ -0,0 +1,371 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   RPNCache.cpp                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: benpicar <benpicar@student.42mulhouse.fr>  +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 19:05:48 by benpicar          #+#    #+#             */
+/*   Updated: 2026/10/19 19:05:48 by benpicar         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "RPNCache.hpp"
+
+const size_t	RPNCache::npos;
+
+/**
+ * @brief	Default constructor for Result, with no outcome yet.
+ */
+RPNCache::Result::Result() : outcome(UNKNOWN), text()
+{}
+
+/**
+ * @brief	Default constructor for Entry, an unused slot.
+ */
+RPNCache::Entry::Entry() : hash(0), key(), program(), bytes(0), next(npos), used(false),
+	referenced(false)
+{}
+
+/**
+ * @brief	Default constructor for RPNCache, disabled until given a
+ * 			capacity.
+ */
+RPNCache::RPNCache() : _capacity(0), _bytes(0), _count(0), _hand(0), _hits(0), _misses(0),
+	_evictions(0)
+{}
+
+/**
+ * @brief	Copy constructor for RPNCache.
+ *
+ * @param	origin The RPNCache object to copy from.
+ */
+RPNCache::RPNCache(const RPNCache &origin) : _entries(origin._entries),
+	_buckets(origin._buckets), _free(origin._free), _capacity(origin._capacity),
+	_bytes(origin._bytes), _count(origin._count), _hand(origin._hand), _hits(origin._hits),
+	_misses(origin._misses), _evictions(origin._evictions)
+{}
+
+/**
+ * @brief	Assignment operator for RPNCache.
+ *
+ * @param	other The RPNCache object to assign from.
+ * @return	A reference to the current RPNCache object.
+ */
+RPNCache	&RPNCache::operator=(const RPNCache &other)
+{
+	if (this != &other)
+	{
+		_entries = other._entries;
+		_buckets = other._buckets;
+		_free = other._free;
+		_capacity = other._capacity;
+		_bytes = other._bytes;
+		_count = other._count;
+		_hand = other._hand;
+		_hits = other._hits;
+		_misses = other._misses;
+		_evictions = other._evictions;
+	}
+	return (*this);
+}
+
+/**
+ * @brief	Destructor for RPNCache.
+ */
+RPNCache::~RPNCache()
+{}
+
+/**
+ * @brief	Builds the key of an expression: its tokens joined by single
+ * 			spaces, whatever the whitespace and the split into arguments.
+ * 			Two expressions with the same key are evaluated the same way,
+ * 			malformed ones included, since a word of several characters is
+ * 			kept whole.
+ *
+ * @param	expressions An array of strings representing the RPN expressions.
+ * @param	length The number of expressions in the array.
+ * @return	The normalized token sequence.
+ */
+std::string	RPNCache::normalize(char **expressions, int length)
+{
+	std::string	key;
+
+	for (int i = 0; i < length; ++i)
+	{
+		const char	*p = expressions[i];
+		if (!p)
+			continue ;
+		while (*p)
+		{
+			if (isspace(static_cast<unsigned char>(*p)))
+			{
+				p++;
+				continue ;
+			}
+			if (!key.empty())
+				key += ' ';
+			while (*p && !isspace(static_cast<unsigned char>(*p)))
+				key += *p++;
+		}
+	}
+	return (key);
+}
+
+/**
+ * @brief	64-bit FNV-1a hash of a key.
+ */
+unsigned long long	RPNCache::hash(const std::string &key)
+{
+	unsigned long long	h = 0xCBF29CE484222325ULL;
+
+	for (size_t i = 0; i < key.size(); ++i)
+	{
+		h ^= static_cast<unsigned char>(key[i]);
+		h *= 0x100000001B3ULL;
+	}
+	return (h);
+}
+
+/**
+ * @brief	Bytes an entry is charged: the slot itself, the key, the
+ * 			program's instructions and the result texts.
+ */
+size_t	RPNCache::cost(const Entry &entry) const
+{
+	size_t	bytes = sizeof(Entry) + entry.key.size()
+		+ entry.program.getCode().size() * sizeof(RPNProgram::Instruction);
+
+	for (size_t t = 0; t < CACHE_VALUE_TYPES; ++t)
+		bytes += entry.results[t].text.size();
+	return (bytes);
+}
+
+/**
+ * @brief	Puts an entry at the head of its bucket's chain.
+ */
+void	RPNCache::link(size_t index)
+{
+	size_t	bucket = static_cast<size_t>(_entries[index].hash) & (_buckets.size() - 1);
+
+	_entries[index].next = _buckets[bucket];
+	_buckets[bucket] = index;
+}
+
+/**
+ * @brief	Takes an entry out of its bucket's chain.
+ */
+void	RPNCache::unlink(size_t index)
+{
+	size_t	*link = &_buckets[static_cast<size_t>(_entries[index].hash) & (_buckets.size() - 1)];
+
+	while (*link != index)
+		link = &_entries[*link].next;
+	*link = _entries[index].next;
+}
+
+/**
+ * @brief	Doubles the bucket array, keeping at most one entry per bucket
+ * 			on average, and relinks every entry.
+ */
+void	RPNCache::rehash()
+{
+	_buckets.assign(_buckets.empty() ? 64 : _buckets.size() * 2, npos);
+	for (size_t i = 0; i < _entries.size(); ++i)
+	{
+		if (_entries[i].used)
+			link(i);
+	}
+}
+
+/**
+ * @brief	Removes an entry and releases its memory, the slot being kept
+ * 			for a later entry.
+ */
+void	RPNCache::remove(size_t index)
+{
+	Entry	&entry = _entries[index];
+
+	unlink(index);
+	_bytes -= entry.bytes;
+	_count--;
+	entry.used = false;
+	std::string().swap(entry.key);
+	entry.program.clear();
+	for (size_t t = 0; t < CACHE_VALUE_TYPES; ++t)
+		entry.results[t] = Result();
+	_free.push_back(index);
+}
+
+/**
+ * @brief	Runs the CLOCK hand until needed more bytes fit. An entry used
+ * 			since the hand last passed loses its mark and is spared; one
+ * 			without the mark is removed.
+ *
+ * @param	keep An entry never evicted, or npos.
+ * @param	needed The bytes about to be added.
+ */
+void	RPNCache::evict(size_t keep, size_t needed)
+{
+	while (_count > (keep != npos ? 1U : 0U) && _bytes + needed > _capacity)
+	{
+		Entry	&entry = _entries[_hand];
+
+		if (entry.used && _hand != keep)
+		{
+			if (entry.referenced)
+				entry.referenced = false;
+			else
+			{
+				remove(_hand);
+				_evictions++;
+			}
+		}
+		_hand = (_hand + 1) % _entries.size();
+	}
+}
+
+/**
+ * @brief	Set the size of the cache, evicting entries if it shrinks.
+ *
+ * @param	bytes The capacity in bytes, 0 disabling the cache.
+ */
+void	RPNCache::setCapacity(size_t bytes)
+{
+	_capacity = bytes;
+	evict(npos, 0);
+}
+
+/**
+ * @brief	Get the size of the cache in bytes, 0 if it is disabled.
+ */
+size_t	RPNCache::getCapacity() const
+{
+	return (_capacity);
+}
+
+/**
+ * @brief	Looks an expression up, marking its entry as used.
+ *
+ * @param	key The normalized expression.
+ * @return	The index of the entry, or npos.
+ */
+size_t	RPNCache::find(const std::string &key)
+{
+	unsigned long long	h;
+
+	if (_count == 0)
+		return (npos);
+	h = hash(key);
+	for (size_t i = _buckets[static_cast<size_t>(h) & (_buckets.size() - 1)]; i != npos;
+		i = _entries[i].next)
+	{
+		if (_entries[i].hash == h && _entries[i].key == key)
+		{
+			_entries[i].referenced = true;
+			return (i);
+		}
+	}
+	return (npos);
+}
+
+/**
+ * @brief	Adds the compiled program of an expression not cached yet,
+ * 			evicting entries to make room.
+ *
+ * @param	key The normalized expression.
+ * @param	program Its compiled program.
+ * @return	The index of the new entry, or npos if the cache is disabled
+ * 			or the entry alone would not fit.
+ */
+size_t	RPNCache::insert(const std::string &key, const RPNProgram &program)
+{
+	Entry	entry;
+	size_t	index;
+
+	entry.hash = hash(key);
+	entry.key = key;
+	entry.program = program;
+	entry.used = true;
+	entry.referenced = true;
+	entry.bytes = cost(entry);
+	if (entry.bytes > _capacity)
+		return (npos);
+	evict(npos, entry.bytes);
+	if (_free.empty())
+	{
+		index = _entries.size();
+		_entries.push_back(entry);
+	}
+	else
+	{
+		index = _free.back();
+		_free.pop_back();
+		_entries[index] = entry;
+	}
+	_bytes += entry.bytes;
+	if (++_count > _buckets.size())
+		rehash();
+	else
+		link(index);
+	return (index);
+}
+
+/**
+ * @brief	Records the outcome of an entry for a value type, evicting
+ * 			other entries if it no longer fits. An entry grown past the
+ * 			whole capacity is removed, so the index must not be used after.
+ *
+ * @param	index The entry.
+ * @param	type The value type the outcome belongs to.
+ * @param	result The outcome.
+ */
+void	RPNCache::store(size_t index, size_t type, const Result &result)
+{
+	Entry	&entry = _entries[index];
+	size_t	bytes;
+
+	entry.results[type] = result;
+	bytes = cost(entry);
+	_bytes = _bytes - entry.bytes + bytes;
+	entry.bytes = bytes;
+	if (bytes > _capacity)
+		remove(index);
+	else
+		evict(index, 0);
+}
+
+/**
+ * @brief	Get an entry found or inserted before.
+ */
+RPNCache::Entry const	&RPNCache::getEntry(size_t index) const
+{
+	return (_entries[index]);
+}
+
+/**
+ * @brief	Counts an evaluation answered from the cache.
+ */
+void	RPNCache::countHit()
+{
+	_hits++;
+}
+
+/**
+ * @brief	Counts an evaluation that had to run, possibly reusing a cached
+ * 			program.
+ */
+void	RPNCache::countMiss()
+{
+	_misses++;
+}
+
+/**
+ * @brief	Writes the counters of the cache on one line.
+ */
+void	RPNCache::report(std::ostream &out) const
+{
+	out << "Cache: " << _hits << " hits, " << _misses << " misses, " << _evictions
+		<< " evictions, " << _count << " entries, " << _bytes << " of " << _capacity
+		<< " bytes" << std::endl;
+}
@@ -0,0 +1,117 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   RPNCache.hpp                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: benpicar <benpicar@student.42mulhouse.fr>  +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 19:05:48 by benpicar          #+#    #+#             */
+/*   Updated: 2026/10/19 19:05:48 by benpicar         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma once
+
+#ifndef RPNCACHE_HPP
+# define RPNCACHE_HPP
+
+# include <iostream>
+# include <string>
+# include <vector>
+# include "RPNProgram.hpp"
+
+/* Value types an entry keeps an outcome for, one per RPN::ValueType */
+# define CACHE_VALUE_TYPES 4
+
+/* Cache size of --batch when --cache is not given, in bytes */
+# define CACHE_DEFAULT_BYTES (16 << 20)
+
+/**
+ * @brief	Bounded memo of evaluated expressions.
+ * 			Entries are keyed by the normalized token sequence of the
+ * 			expression (see normalize), found through its 64-bit hash, and
+ * 			hold the compiled program plus, for each value type already
+ * 			evaluated, the outcome: the printed result or the error raised,
+ * 			division by zero included. Expressions have no variables, so an
+ * 			outcome never goes stale.
+ * 			The cache is sized in bytes, counting each entry's key, program
+ * 			and results. When full, entries are evicted with the CLOCK
+ * 			algorithm: a hand sweeps the entries, sparing once those used
+ * 			since its last pass.
+ */
+class RPNCache
+{
+	public:
+		enum Outcome
+		{
+			UNKNOWN,
+			VALUE,
+			INVALID_ARGUMENT,
+			NOT_ENOUGH_OPERANDS,
+			TOO_MANY_OPERANDS
+		};
+
+		struct Result
+		{
+			Outcome		outcome;
+			std::string	text;
+
+			Result();
+		};
+
+		struct Entry
+		{
+			unsigned long long	hash;
+			std::string			key;
+			RPNProgram			program;
+			Result				results[CACHE_VALUE_TYPES];
+			size_t				bytes;
+			size_t				next;
+			bool				used;
+			bool				referenced;
+
+			Entry();
+		};
+
+		static const size_t	npos = static_cast<size_t>(-1);
+
+	private:
+		std::vector<Entry>	_entries;
+		std::vector<size_t>	_buckets;
+		std::vector<size_t>	_free;
+		size_t				_capacity;
+		size_t				_bytes;
+		size_t				_count;
+		size_t				_hand;
+		unsigned long		_hits;
+		unsigned long		_misses;
+		unsigned long		_evictions;
+
+		static unsigned long long	hash(const std::string &key);
+		size_t		cost(const Entry &entry) const;
+		void		link(size_t index);
+		void		unlink(size_t index);
+		void		remove(size_t index);
+		void		rehash();
+		void		evict(size_t keep, size_t needed);
+
+	public:
+		RPNCache();
+		RPNCache(const RPNCache &origin);
+		RPNCache	&operator=(const RPNCache &other);
+		~RPNCache();
+
+		static std::string	normalize(char **expressions, int length);
+
+		void		setCapacity(size_t bytes);
+		size_t		getCapacity() const;
+		size_t		find(const std::string &key);
+		size_t		insert(const std::string &key, const RPNProgram &program);
+		void		store(size_t index, size_t type, const Result &result);
+		Entry const	&getEntry(size_t index) const;
+		void		countHit();
+		void		countMiss();
+		void		report(std::ostream &out) const;
+};
+
+#endif
@@ -0,0 +1,585 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   RPNNative.cpp                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: benpicar <benpicar@student.42mulhouse.fr>  +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 18:02:14 by benpicar          #+#    #+#             */
+/*   Updated: 2026/10/19 18:02:14 by benpicar         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "RPNNative.hpp"
+#include <cstring>
+#include <unistd.h>
+#include <sys/mman.h>
+
+/*
+ * Registers holding nodes: rcx, rsi, r8 to r10, then the callee-saved rbx,
+ * rbp and r12 to r15. rax, rdx and r11 are kept for the divisions, rdi
+ * holds the frame.
+ */
+static const int	g_pool[] = {1, 6, 8, 9, 10, 3, 5, 12, 13, 14, 15};
+
+/* Callee-saved registers of the pool, saved by the prologue: rbx, rbp, r12-r15 */
+static const int	g_saved[] = {3, 5, 12, 13, 14, 15};
+
+static const size_t	g_poolSize = sizeof(g_pool) / sizeof(g_pool[0]);
+static const size_t	g_savedSize = sizeof(g_saved) / sizeof(g_saved[0]);
+static const size_t	g_none = static_cast<size_t>(-1);
+
+/**
+ * @brief	Default constructor for RPNNative, holding no code.
+ */
+RPNNative::RPNNative() : _memory(NULL), _writable(NULL), _mapped(0), _size(0), _spills(0)
+{
+	for (size_t r = 0; r < REGISTERS; ++r)
+		_holder[r] = g_none;
+}
+
+/**
+ * @brief	Copy constructor for RPNNative. Code is not shared: the copy
+ * 			holds none until its own compile.
+ */
+RPNNative::RPNNative(const RPNNative &origin) : _memory(NULL), _writable(NULL), _mapped(0),
+	_size(0), _spills(0)
+{
+	(void)origin;
+	for (size_t r = 0; r < REGISTERS; ++r)
+		_holder[r] = g_none;
+}
+
+/**
+ * @brief	Assignment operator for RPNNative. The code of other is not
+ * 			shared, and this one keeps its own.
+ */
+RPNNative	&RPNNative::operator=(const RPNNative &other)
+{
+	(void)other;
+	return (*this);
+}
+
+/**
+ * @brief	Destructor for RPNNative, unmapping the code.
+ */
+RPNNative::~RPNNative()
+{
+	release();
+}
+
+/**
+ * @brief	Unmap the code, if any.
+ */
+void	RPNNative::release()
+{
+	if (_writable != NULL && _writable != _memory)
+		munmap(_writable, _mapped);
+	if (_memory != NULL)
+		munmap(_memory, _mapped);
+	_memory = NULL;
+	_writable = NULL;
+	_mapped = 0;
+}
+
+/**
+ * @brief	Whether this build can produce native code: an x86-64 target
+ * 			with anonymous mappings.
+ */
+bool	RPNNative::isSupported()
+{
+#if defined(__x86_64__) && defined(MAP_ANON)
+	return (true);
+#else
+	return (false);
+#endif
+}
+
+/**
+ * @brief	Append a byte. The buffer is sized by compile for the whole
+ * 			program (see NATIVE_NODE_BYTES).
+ */
+void	RPNNative::emit(unsigned char byte)
+{
+	_text[_size++] = byte;
+}
+
+/**
+ * @brief	Append a 32-bit little endian value.
+ */
+void	RPNNative::emit32(unsigned int value)
+{
+	for (int i = 0; i < 4; ++i)
+		emit(static_cast<unsigned char>(value >> (8 * i)));
+}
+
+/**
+ * @brief	Append the REX prefix of a 64-bit operation, extending the reg
+ * 			and r/m fields of the ModR/M byte to r8-r15.
+ */
+void	RPNNative::emitRex(int reg, int rm)
+{
+	emit(static_cast<unsigned char>(0x48 | ((reg >> 3) << 2) | (rm >> 3)));
+}
+
+/**
+ * @brief	Append an instruction taking a register and a register or
+ * 			memory operand. Memory operands are frame slots, addressed from
+ * 			rdi with a 32-bit displacement.
+ */
+void	RPNNative::emitModRm(const unsigned char *opcode, size_t length, int reg,
+	const Operand &rm)
+{
+	int	base = (rm.kind == Operand::REGISTER) ? static_cast<int>(rm.value) : RDI;
+
+	emitRex(reg, base);
+	for (size_t i = 0; i < length; ++i)
+		emit(opcode[i]);
+	if (rm.kind == Operand::REGISTER)
+	{
+		emit(static_cast<unsigned char>(0xC0 | ((reg & 7) << 3) | (base & 7)));
+		return ;
+	}
+	emit(static_cast<unsigned char>(0x80 | ((reg & 7) << 3) | (RDI & 7)));
+	emit32(static_cast<unsigned int>(rm.value * sizeof(long long)));
+}
+
+/**
+ * @brief	mov reg, source.
+ */
+void	RPNNative::emitLoad(int reg, const Operand &source)
+{
+	static const unsigned char	mov[] = {0x8B};
+
+	if (source.kind == Operand::IMMEDIATE)
+	{
+		emitRex(0, reg);
+		emit(0xC7);
+		emit(static_cast<unsigned char>(0xC0 | (reg & 7)));
+		emit32(static_cast<unsigned int>(source.value));
+	}
+	else if (source.kind == Operand::MEMORY || static_cast<int>(source.value) != reg)
+		emitModRm(mov, sizeof(mov), reg, source);
+}
+
+/**
+ * @brief	mov [rdi + 8 * slot], reg.
+ */
+void	RPNNative::emitStore(size_t slot, int reg)
+{
+	static const unsigned char	mov[] = {0x89};
+	Operand						memory;
+
+	memory.kind = Operand::MEMORY;
+	memory.value = slot;
+	emitModRm(mov, sizeof(mov), reg, memory);
+}
+
+/**
+ * @brief	reg = reg op source for an addition, subtraction or
+ * 			multiplication, followed by the jump to the overflow exit.
+ */
+void	RPNNative::emitArithmetic(RPNProgram::OpCode op, int reg, const Operand &source)
+{
+	static const unsigned char	add[] = {0x03};
+	static const unsigned char	sub[] = {0x2B};
+	static const unsigned char	imul[] = {0x0F, 0xAF};
+
+	if (source.kind == Operand::IMMEDIATE && op == RPNProgram::MUL)
+	{
+		emitRex(reg, reg);
+		emit(0x69);
+		emit(static_cast<unsigned char>(0xC0 | ((reg & 7) << 3) | (reg & 7)));
+		emit32(static_cast<unsigned int>(source.value));
+	}
+	else if (source.kind == Operand::IMMEDIATE)
+	{
+		emitRex(0, reg);
+		emit(0x81);
+		emit(static_cast<unsigned char>((op == RPNProgram::ADD ? 0xC0 : 0xE8) | (reg & 7)));
+		emit32(static_cast<unsigned int>(source.value));
+	}
+	else if (op == RPNProgram::MUL)
+		emitModRm(imul, sizeof(imul), reg, source);
+	else
+		emitModRm(op == RPNProgram::ADD ? add : sub, 1, reg, source);
+	emitJump(0x80, _overflowJumps);
+}
+
+/**
+ * @brief	rax = left / right, truncated like BigInt. A zero divisor jumps
+ * 			to the division by zero exit, and -1 negates instead of
+ * 			dividing so that LLONG_MIN / -1 reaches the overflow exit rather
+ * 			than trapping. Digits are never -1, so only a zero digit needs a
+ * 			check, which it always fails.
+ */
+void	RPNNative::emitDivision(const Operand &left, const Operand &right)
+{
+	emitLoad(RAX, left);
+	if (right.kind == Operand::IMMEDIATE && right.value == 0)
+		emitJump(0, _zeroJumps);
+	emitLoad(R11, right);
+	if (right.kind != Operand::IMMEDIATE)
+	{
+		// test r11, r11 ; jz zero
+		emit(0x4D);
+		emit(0x85);
+		emit(0xDB);
+		emitJump(0x84, _zeroJumps);
+		// cmp r11, -1 ; jne divide ; neg rax ; jo overflow ; jmp done
+		emit(0x49);
+		emit(0x83);
+		emit(0xFB);
+		emit(0xFF);
+		emit(0x75);
+		emit(11);
+		emit(0x48);
+		emit(0xF7);
+		emit(0xD8);
+		emitJump(0x80, _overflowJumps);
+		emit(0xEB);
+		emit(5);
+	}
+	// divide: cqo ; idiv r11
+	emit(0x48);
+	emit(0x99);
+	emit(0x49);
+	emit(0xF7);
+	emit(0xFB);
+}
+
+/**
+ * @brief	Append a jump with a 32-bit offset to one of the exits, to be
+ * 			patched once the exit is placed.
+ *
+ * @param	condition The second opcode byte of the Jcc (0x80 jo, 0x84 jz),
+ * 			0 for an unconditional jmp.
+ * @param	jumps Receives where the offset is.
+ */
+void	RPNNative::emitJump(unsigned char condition, std::vector<size_t> &jumps)
+{
+	if (condition != 0)
+	{
+		emit(0x0F);
+		emit(condition);
+	}
+	else
+		emit(0xE9);
+	jumps.push_back(_size);
+	emit32(0);
+}
+
+/**
+ * @brief	Point jumps at a position of the code.
+ */
+void	RPNNative::patch(const std::vector<size_t> &jumps, size_t target)
+{
+	for (size_t i = 0; i < jumps.size(); ++i)
+	{
+		unsigned int	offset = static_cast<unsigned int>(target - (jumps[i] + 4));
+
+		for (int b = 0; b < 4; ++b)
+			_text[jumps[i] + b] = static_cast<unsigned char>(offset >> (8 * b));
+	}
+}
+
+/**
+ * @brief	Where the value of a node is: digits (nodes 0 to 9, see
+ * 			RPNProgram::compile) are immediates, other nodes are in a
+ * 			register until evicted to their frame slot.
+ */
+RPNNative::Operand	RPNNative::operand(size_t node) const
+{
+	Operand	result;
+
+	if (node <= 9)
+	{
+		result.kind = Operand::IMMEDIATE;
+		result.value = node;
+	}
+	else if (_location[node] >= 0)
+	{
+		result.kind = Operand::REGISTER;
+		result.value = static_cast<size_t>(_location[node]);
+	}
+	else
+	{
+		result.kind = Operand::MEMORY;
+		result.value = _slot[node];
+	}
+	return (result);
+}
+
+/**
+ * @brief	Take a free register, or else evict the node used last among
+ * 			those held, the operands of the current node excepted, to a new
+ * 			frame slot.
+ */
+int	RPNNative::allocate(size_t left, size_t right)
+{
+	int		victim = -1;
+
+	for (size_t i = 0; i < g_poolSize; ++i)
+	{
+		int		reg = g_pool[i];
+		size_t	node = _holder[reg];
+
+		if (node == g_none)
+			return (reg);
+		if (node == left || node == right)
+			continue ;
+		if (victim < 0 || _lastUse[node] > _lastUse[_holder[victim]])
+			victim = reg;
+	}
+	size_t	node = _holder[victim];
+
+	_slot[node] = ++_spills;
+	emitStore(_slot[node], victim);
+	_location[node] = -1;
+	_holder[victim] = g_none;
+	return (victim);
+}
+
+/**
+ * @brief	Free the register of a node whose last use is the given one.
+ */
+void	RPNNative::discard(size_t node, size_t use)
+{
+	if (node <= 9 || _lastUse[node] != use || _location[node] < 0)
+		return ;
+	_holder[_location[node]] = g_none;
+	_location[node] = -1;
+}
+
+/**
+ * @brief	Translate one operator node, leaving its value in a register.
+ * 			An addition, subtraction or multiplication computes in place in
+ * 			the register of its left operand when this is its last use.
+ */
+void	RPNNative::translate(const std::vector<RPNProgram::Instruction> &code, size_t i)
+{
+	const RPNProgram::Instruction	&node = code[i];
+	Operand							left = operand(node.left);
+	Operand							right = operand(node.right);
+	int								reg;
+
+	if (node.op == RPNProgram::DIV)
+	{
+		Operand	quotient;
+
+		emitDivision(left, right);
+		discard(node.left, i);
+		discard(node.right, i);
+		reg = allocate(g_none, g_none);
+		quotient.kind = Operand::REGISTER;
+		quotient.value = RAX;
+		emitLoad(reg, quotient);
+	}
+	else
+	{
+		if (left.kind == Operand::REGISTER && _lastUse[node.left] == i)
+		{
+			reg = _location[node.left];
+			_holder[reg] = g_none;
+			_location[node.left] = -1;
+		}
+		else
+		{
+			reg = allocate(node.left, node.right);
+			emitLoad(reg, left);
+		}
+		emitArithmetic(node.op, reg, right);
+		discard(node.left, i);
+		discard(node.right, i);
+	}
+	if (_lastUse[i] == 0)
+		return ;
+	_holder[reg] = i;
+	_location[i] = reg;
+}
+
+/**
+ * @brief	Translate a program. The code is called with the frame in rdi:
+ * 			slot 0 receives the Status, the others hold evicted nodes. It
+ * 			returns the value in rax.
+ *
+ * @param	program A compiled program.
+ * @return	false, leaving the program to the interpreter, if the target is
+ * 			not supported, the program is too large or ends with a
+ * 			structural error, or the code cannot be mapped.
+ */
+bool	RPNNative::compile(const RPNProgram &program)
+{
+	const std::vector<RPNProgram::Instruction>	&code = program.getCode();
+	size_t										n = code.size();
+
+	if (!isSupported() || program.getFailure() != RPNProgram::NONE || n > NATIVE_MAX_NODES)
+		return (false);
+	if (_text.size() < n * NATIVE_NODE_BYTES + NATIVE_FRAME_BYTES)
+		_text.resize(n * NATIVE_NODE_BYTES + NATIVE_FRAME_BYTES);
+	_size = 0;
+	_location.assign(n, -1);
+	_slot.assign(n, 0);
+	_lastUse.assign(n, 0);
+	for (size_t r = 0; r < REGISTERS; ++r)
+		_holder[r] = g_none;
+	_spills = 0;
+	_overflowJumps.clear();
+	_zeroJumps.clear();
+	for (size_t i = 0; i < n; ++i)
+	{
+		if (code[i].op == RPNProgram::PUSH)
+			continue ;
+		_lastUse[code[i].left] = i;
+		_lastUse[code[i].right] = i;
+	}
+	_lastUse[program.getResult()] = n;
+
+	for (size_t i = 0; i < g_savedSize; ++i)
+	{
+		if (g_saved[i] >= R8)
+			emit(0x41);
+		emit(static_cast<unsigned char>(0x50 + (g_saved[i] & 7)));
+	}
+	for (size_t i = 0; i < n; ++i)
+	{
+		if (code[i].op != RPNProgram::PUSH)
+			translate(code, i);
+	}
+	emitLoad(RAX, operand(program.getResult()));
+
+	size_t	epilogue = _size;
+	for (size_t i = g_savedSize; i-- > 0;)
+	{
+		if (g_saved[i] >= R8)
+			emit(0x41);
+		emit(static_cast<unsigned char>(0x58 + (g_saved[i] & 7)));
+	}
+	emit(0xC3);
+	// Exits: mov qword [rdi], status ; jmp epilogue
+	for (int status = OVERFLOWED; status <= DIVISION_BY_ZERO; ++status)
+	{
+		patch(status == OVERFLOWED ? _overflowJumps : _zeroJumps, _size);
+		emit(0x48);
+		emit(0xC7);
+		emit(0x07);
+		emit32(static_cast<unsigned int>(status));
+		emit(0xE9);
+		emit32(static_cast<unsigned int>(epilogue - (_size + 4)));
+	}
+	_frame.assign(_spills + 1, 0);
+	return (map());
+}
+
+/**
+ * @brief	Run the code made by a successful compile.
+ *
+ * @param	value Receives the value of the expression when DONE.
+ * @return	DONE, DIVISION_BY_ZERO which is the outcome of the expression,
+ * 			or OVERFLOWED when the interpreter must evaluate it instead.
+ */
+RPNNative::Status	RPNNative::run(long long &value)
+{
+	Function	function = reinterpret_cast<Function>(_memory);
+
+	_frame[0] = DONE;
+	value = function(&_frame[0]);
+	return (static_cast<Status>(_frame[0]));
+}
+
+/**
+ * @brief	Map an anonymous shared file twice, writable and executable,
+ * 			so new code is copied without changing any protection.
+ *
+ * @return	false where memfd_create is missing or the views are refused.
+ */
+bool	RPNNative::mapShared(size_t size)
+{
+#if defined(__linux__) && defined(MFD_CLOEXEC)
+	int		fd = memfd_create("rpn-native", MFD_CLOEXEC);
+	void	*writable = MAP_FAILED;
+	void	*executable = MAP_FAILED;
+
+	if (fd < 0)
+		return (false);
+	if (ftruncate(fd, size) == 0)
+	{
+		writable = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		executable = mmap(NULL, size, PROT_READ | PROT_EXEC, MAP_SHARED, fd, 0);
+	}
+	close(fd);
+	if (writable == MAP_FAILED || executable == MAP_FAILED)
+	{
+		if (writable != MAP_FAILED)
+			munmap(writable, size);
+		if (executable != MAP_FAILED)
+			munmap(executable, size);
+		return (false);
+	}
+	_memory = executable;
+	_writable = writable;
+	_mapped = size;
+	return (true);
+#else
+	(void)size;
+	return (false);
+#endif
+}
+
+/**
+ * @brief	Map private memory, switched between writable and executable
+ * 			around each copy of the code.
+ *
+ * @return	false if the system refuses the mapping.
+ */
+bool	RPNNative::mapPrivate(size_t size)
+{
+#if defined(MAP_ANON)
+	void	*memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+
+	if (memory == MAP_FAILED)
+		return (false);
+	_memory = memory;
+	_writable = memory;
+	_mapped = size;
+	return (true);
+#else
+	(void)size;
+	return (false);
+#endif
+}
+
+/**
+ * @brief	Copy the code to the mapping of the previous compile when it
+ * 			fits, or else to a new one. No page is ever writable and
+ * 			executable at once: either the code is written through a
+ * 			writable view of the executable pages, or the single view is
+ * 			made writable for the copy then executable again.
+ *
+ * @return	false if the system refuses the mapping.
+ */
+bool	RPNNative::map()
+{
+	size_t	page = 4096;
+	size_t	size = (_size + page - 1) / page * page;
+
+	if (_memory != NULL && size > _mapped)
+		release();
+	if (_memory == NULL)
+	{
+		if (!mapShared(size) && !mapPrivate(size))
+			return (false);
+	}
+	else if (_writable == _memory && mprotect(_memory, _mapped, PROT_READ | PROT_WRITE) != 0)
+	{
+		release();
+		return (false);
+	}
+	std::memcpy(_writable, &_text[0], _size);
+	if (_writable == _memory && mprotect(_memory, _mapped, PROT_READ | PROT_EXEC) != 0)
+	{
+		release();
+		return (false);
+	}
+	return (true);
+}
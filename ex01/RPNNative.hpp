@@ -0,0 +1,142 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   RPNNative.hpp                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: benpicar <benpicar@student.42mulhouse.fr>  +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 18:02:14 by benpicar          #+#    #+#             */
+/*   Updated: 2026/10/19 18:02:14 by benpicar         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma once
+
+#ifndef RPNNATIVE_HPP
+# define RPNNATIVE_HPP
+
+# include <cstddef>
+# include <vector>
+# include "RPNProgram.hpp"
+
+/* Largest program translated to native code; larger ones are interpreted */
+# define NATIVE_MAX_NODES (1 << 20)
+
+/* Bound on the code of one node, and on the code around the nodes, in bytes */
+# define NATIVE_NODE_BYTES 64
+# define NATIVE_FRAME_BYTES 128
+
+/**
+ * @brief	x86-64 machine code for a validated RPN program.
+ * 			Every DAG node becomes a few instructions on 64-bit integers,
+ * 			written to an mmap'd buffer made executable once complete. The
+ * 			nodes computed last, the top of the RPN stack, stay in registers:
+ * 			a node is only stored to memory when registers run out, the one
+ * 			needed last being evicted. Digits are immediate operands.
+ * 			Additions, subtractions and multiplications are checked for
+ * 			overflow (jo), as is LLONG_MIN / -1, and divisions keep their
+ * 			check against zero. Nodes run in the order of the interpreter, so
+ * 			the first event met is the one it would meet: a division by zero
+ * 			is final, while an overflow means the exact interpreter must take
+ * 			over. Other targets, and programs the interpreter must report on,
+ * 			are not compiled (see compile). The mapping and the buffers are
+ * 			reused by the next compile, so translating a program does not
+ * 			allocate once they are large enough, nor make a system call when
+ * 			the code is mapped twice (see map).
+ */
+class RPNNative
+{
+	public:
+		enum Status
+		{
+			DONE,
+			OVERFLOWED,
+			DIVISION_BY_ZERO
+		};
+
+	private:
+		enum Register
+		{
+			RAX = 0,
+			RCX = 1,
+			RDX = 2,
+			RBX = 3,
+			RSP = 4,
+			RBP = 5,
+			RSI = 6,
+			RDI = 7,
+			R8 = 8,
+			R9 = 9,
+			R10 = 10,
+			R11 = 11,
+			R12 = 12,
+			R13 = 13,
+			R14 = 14,
+			R15 = 15,
+			REGISTERS = 16
+		};
+
+		struct Operand
+		{
+			enum Kind
+			{
+				IMMEDIATE,
+				REGISTER,
+				MEMORY
+			};
+
+			Kind	kind;
+			size_t	value;
+		};
+
+		typedef long long	(*Function)(long long *frame);
+
+		void						*_memory;
+		void						*_writable;
+		size_t						_mapped;
+		std::vector<long long>		_frame;
+
+		std::vector<unsigned char>	_text;
+		size_t						_size;
+		std::vector<int>			_location;
+		std::vector<size_t>			_slot;
+		std::vector<size_t>			_lastUse;
+		size_t						_holder[REGISTERS];
+		size_t						_spills;
+		std::vector<size_t>			_overflowJumps;
+		std::vector<size_t>			_zeroJumps;
+
+		void		release();
+		void		emit(unsigned char byte);
+		void		emit32(unsigned int value);
+		void		emitRex(int reg, int rm);
+		void		emitModRm(const unsigned char *opcode, size_t length, int reg,
+						const Operand &rm);
+		void		emitLoad(int reg, const Operand &source);
+		void		emitStore(size_t slot, int reg);
+		void		emitArithmetic(RPNProgram::OpCode op, int reg, const Operand &source);
+		void		emitDivision(const Operand &left, const Operand &right);
+		void		emitJump(unsigned char condition, std::vector<size_t> &jumps);
+		void		patch(const std::vector<size_t> &jumps, size_t target);
+
+		Operand		operand(size_t node) const;
+		int			allocate(size_t left, size_t right);
+		void		discard(size_t node, size_t use);
+		void		translate(const std::vector<RPNProgram::Instruction> &code, size_t i);
+		bool		mapShared(size_t size);
+		bool		mapPrivate(size_t size);
+		bool		map();
+
+	public:
+		RPNNative();
+		RPNNative(const RPNNative &origin);
+		RPNNative	&operator=(const RPNNative &other);
+		~RPNNative();
+
+		static bool	isSupported();
+
+		bool		compile(const RPNProgram &program);
+		Status		run(long long &value);
+};
+
+#endif
@@ -0,0 +1,538 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   RPNProgram.cpp                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: benpicar <benpicar@student.42mulhouse.fr>  +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 12:31:37 by benpicar          #+#    #+#             */
+/*   Updated: 2026/10/19 12:39:10 by benpicar         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "RPNProgram.hpp"
+#include "RPN.hpp"
+
+/**
+ * @brief	Default constructor for RPNProgram.
+ */
+RPNProgram::RPNProgram() : _code(), _table(), _stack(), _operations(0), _result(0),
+	_failure(NONE), _signedZeros(false)
+{}
+
+/**
+ * @brief	Copy constructor for RPNProgram.
+ * 
+ * @param	origin The RPNProgram object to copy from.
+ */
+RPNProgram::RPNProgram(const RPNProgram &origin) : _code(origin._code),
+	_table(origin._table), _stack(origin._stack), _operations(origin._operations),
+	_result(origin._result), _failure(origin._failure), _signedZeros(origin._signedZeros)
+{}
+
+/**
+ * @brief	Assignment operator for RPNProgram.
+ * 
+ * @param	other The RPNProgram object to assign from.
+ * @return	A reference to the current RPNProgram object.
+ */
+RPNProgram	&RPNProgram::operator=(const RPNProgram &other)
+{
+	if (this != &other)
+	{
+		_code = other._code;
+		_table = other._table;
+		_stack = other._stack;
+		_operations = other._operations;
+		_result = other._result;
+		_failure = other._failure;
+		_signedZeros = other._signedZeros;
+	}
+	return (*this);
+}
+
+/**
+ * @brief	Destructor for RPNProgram.
+ */
+RPNProgram::~RPNProgram()
+{}
+
+/**
+ * @brief	Check if a node is the given single digit literal.
+ */
+bool	RPNProgram::isLiteral(size_t node, int value) const
+{
+	return (node == static_cast<size_t>(value));
+}
+
+/**
+ * @brief	Hash a node by its structure, children being already unique.
+ */
+size_t	RPNProgram::hash(OpCode op, int value, size_t left, size_t right) const
+{
+	unsigned long long	h = static_cast<unsigned long long>(op) * 31 + value;
+
+	h = (h * 0x9E3779B97F4A7C15ULL) ^ left;
+	h = (h * 0x9E3779B97F4A7C15ULL) ^ right;
+	h ^= h >> 29;
+	h *= 0xBF58476D1CE4E5B9ULL;
+	h ^= h >> 32;
+	return (static_cast<size_t>(h) & (_table.size() - 1));
+}
+
+/**
+ * @brief	Double the hash-consing table and reinsert every node.
+ * 			Slots hold the node index plus one, zero meaning empty.
+ */
+void	RPNProgram::growTable()
+{
+	_table.assign(_table.empty() ? 64 : _table.size() * 2, 0);
+	for (size_t i = 0; i < _code.size(); ++i)
+	{
+		size_t	slot = hash(_code[i].op, _code[i].value, _code[i].left, _code[i].right);
+		while (_table[slot])
+			slot = (slot + 1) & (_table.size() - 1);
+		_table[slot] = i + 1;
+	}
+}
+
+/**
+ * @brief	Get the node for a structure, creating it only if no identical
+ * 			node exists yet.
+ * 
+ * @return	The index of the node in the program.
+ */
+size_t	RPNProgram::intern(OpCode op, int value, size_t left, size_t right)
+{
+	Instruction	instruction;
+	size_t		slot;
+
+	if ((_code.size() + 1) * 2 > _table.size())
+		growTable();
+	slot = hash(op, value, left, right);
+	while (_table[slot])
+	{
+		const Instruction	&node = _code[_table[slot] - 1];
+		if (node.op == op && node.value == value && node.left == left && node.right == right)
+			return (_table[slot] - 1);
+		slot = (slot + 1) & (_table.size() - 1);
+	}
+	instruction.op = op;
+	instruction.value = value;
+	instruction.left = left;
+	instruction.right = right;
+	_code.push_back(instruction);
+	_table[slot] = _code.size();
+	return (_code.size() - 1);
+}
+
+/**
+ * @brief	Build an operator node, dropping it when one operand is a
+ * 			neutral literal. A literal never fails, so this cannot hide a
+ * 			division by zero. Adding 0 is only dropped for value types
+ * 			without signed zeros: with doubles, -0 + 0 is +0.
+ * 
+ * @return	The index of the node holding the result.
+ */
+size_t	RPNProgram::reduce(OpCode op, size_t left, size_t right)
+{
+	switch (op)
+	{
+		case (ADD):
+			if (_signedZeros)
+				break ;
+			if (isLiteral(right, 0))
+				return (left);
+			if (isLiteral(left, 0))
+				return (right);
+			break ;
+		case (SUB):
+			if (isLiteral(right, 0))
+				return (left);
+			break ;
+		case (MUL):
+			if (isLiteral(right, 1))
+				return (left);
+			if (isLiteral(left, 1))
+				return (right);
+			break ;
+		case (DIV):
+			if (isLiteral(right, 1))
+				return (left);
+			break ;
+		default:
+			break ;
+	}
+	return (intern(op, 0, left, right));
+}
+
+/**
+ * @brief	Compile RPN expressions into an expression DAG.
+ * 			Tokens follow the same rules as RPN::performOperation: single
+ * 			characters separated by whitespace, empty arguments skipped.
+ * 			Compilation stops at the first structural error, which is kept to
+ * 			be raised once the valid prefix has been evaluated.
+ * 
+ * @param	expressions An array of strings representing the RPN expressions.
+ * @param	length The number of expressions in the array.
+ * @param	signedZeros Whether the value type has signed zeros (see reduce).
+ */
+void	RPNProgram::compile(char **expressions, int length, bool signedZeros)
+{
+	OpCode	op;
+	size_t	left, right;
+
+	_code.clear();
+	_table.clear();
+	_stack.clear();
+	_operations = 0;
+	_result = 0;
+	_failure = NONE;
+	_signedZeros = signedZeros;
+	// Digits always get nodes 0 to 9, so literals need no table lookup
+	for (int digit = 0; digit <= 9; ++digit)
+		intern(PUSH, digit, 0, 0);
+	for (int i = 0; i < length && _failure == NONE; ++i)
+	{
+		const char	*expr = expressions[i];
+		if (!expr)
+			continue ;
+		for (size_t idx = 0; expr[idx] && _failure == NONE; ++idx)
+		{
+			if (isspace(expr[idx]))
+				continue ;
+			if (expr[idx + 1] != '\0' && !isspace(expr[idx + 1]))
+			{
+				_failure = BAD_FORMAT;
+				break ;
+			}
+			if (isdigit(expr[idx]))
+			{
+				_stack.push_back(static_cast<size_t>(expr[idx] - '0'));
+				continue ;
+			}
+			switch (expr[idx])
+			{
+				case ('+'):
+					op = ADD;
+					break ;
+				case ('-'):
+					op = SUB;
+					break ;
+				case ('*'):
+					op = MUL;
+					break ;
+				case ('/'):
+					op = DIV;
+					break ;
+				default:
+					_failure = BAD_CHARACTER;
+					continue ;
+			}
+			if (_stack.size() < 2)
+			{
+				_failure = MISSING_OPERANDS;
+				break ;
+			}
+			right = _stack.back();
+			_stack.pop_back();
+			left = _stack.back();
+			_stack.back() = reduce(op, left, right);
+			_operations++;
+		}
+	}
+	if (_failure == NONE && _stack.size() != 1)
+		_failure = TOO_MANY_OPERANDS;
+	if (_failure == NONE)
+		_result = _stack.back();
+	_stack.clear();
+	_table.clear();
+}
+
+/**
+ * @brief	Empty the program and give its memory back.
+ */
+void	RPNProgram::clear()
+{
+	std::vector<Instruction>().swap(_code);
+	std::vector<size_t>().swap(_table);
+	std::vector<size_t>().swap(_stack);
+	_operations = 0;
+	_result = 0;
+	_failure = NONE;
+	_signedZeros = false;
+}
+
+/**
+ * @brief	Throw the structural error the program ends with, if any.
+ * 
+ * @throws	std::invalid_argument on malformed input.
+ * @throws	RPN::NotEnoughOperands if an operator lacks operands.
+ * @throws	RPN::TooManyOperands if the program does not end with one value.
+ */
+void	RPNProgram::raiseFailure() const
+{
+	switch (_failure)
+	{
+		case (BAD_FORMAT):
+			throw std::invalid_argument("Invalid expression format.");
+		case (BAD_CHARACTER):
+			throw std::invalid_argument("Invalid character encountered in expression.");
+		case (MISSING_OPERANDS):
+			throw (RPN::NotEnoughOperands());
+		case (TOO_MANY_OPERANDS):
+			throw (RPN::TooManyOperands());
+		case (NONE):
+			break ;
+	}
+}
+
+/**
+ * @brief	Run the compiled program, each DAG node being computed once.
+ * 			Large programs are split by DAG level across worker threads when
+ * 			more than one thread is allowed.
+ * 
+ * @tparam	T The value type: BigInt, Rational, Decimal or double.
+ * @param	threads The maximum number of threads to use.
+ * @return	The value of the expression.
+ * @throws	std::invalid_argument on division by zero or malformed input.
+ * @throws	RPN::NotEnoughOperands if an operator lacks operands.
+ * @throws	RPN::TooManyOperands if the program does not end with one value.
+ */
+template <typename T>
+T	RPNProgram::execute(unsigned int threads) const
+{
+	if (threads > 1 && _code.size() >= PARALLEL_MIN_WIDTH * 2)
+		return (executeParallel<T>(threads));
+
+	std::vector<T>	values(_code.size());
+
+	for (size_t i = 0; i < _code.size(); ++i)
+	{
+		const Instruction	&node = _code[i];
+		switch (node.op)
+		{
+			case (PUSH):
+				values[i] = Arithmetic<T>::fromDigit(node.value);
+				break ;
+			case (ADD):
+				values[i] = values[node.left] + values[node.right];
+				break ;
+			case (SUB):
+				values[i] = values[node.left] - values[node.right];
+				break ;
+			case (MUL):
+				values[i] = values[node.left] * values[node.right];
+				break ;
+			case (DIV):
+				if (Arithmetic<T>::isZero(values[node.right]))
+					throw std::invalid_argument("Division by zero.");
+				values[i] = values[node.left] / values[node.right];
+				break ;
+		}
+	}
+	raiseFailure();
+	return (values[_result]);
+}
+
+/**
+ * @brief	Compute one node without throwing. A node fails on its own
+ * 			division by zero (state 1) or when one of its operands already
+ * 			failed (state 2), in which case it is left uncomputed.
+ * 
+ * @return	true if the node holds a value.
+ */
+template <typename T>
+bool	RPNProgram::evaluateNode(size_t i, std::vector<T> &values,
+	std::vector<char> &state) const
+{
+	const Instruction	&node = _code[i];
+
+	if (node.op != PUSH && (state[node.left] || state[node.right]))
+	{
+		state[i] = 2;
+		return (false);
+	}
+	switch (node.op)
+	{
+		case (PUSH):
+			values[i] = Arithmetic<T>::fromDigit(node.value);
+			break ;
+		case (ADD):
+			values[i] = values[node.left] + values[node.right];
+			break ;
+		case (SUB):
+			values[i] = values[node.left] - values[node.right];
+			break ;
+		case (MUL):
+			values[i] = values[node.left] * values[node.right];
+			break ;
+		case (DIV):
+			if (Arithmetic<T>::isZero(values[node.right]))
+			{
+				state[i] = 1;
+				return (false);
+			}
+			values[i] = values[node.left] / values[node.right];
+			break ;
+	}
+	return (true);
+}
+
+/**
+ * @brief	Thread entry point, computing a slice of one DAG level.
+ */
+template <typename T>
+void	*RPNProgram::runWorker(void *arg)
+{
+	Worker<T>	*worker = static_cast<Worker<T> *>(arg);
+
+	try
+	{
+		for (size_t i = 0; i < worker->count; ++i)
+			worker->program->evaluateNode(worker->nodes[i], *worker->values, *worker->state);
+	}
+	catch (const std::bad_alloc &)
+	{
+		worker->outOfMemory = true;
+	}
+	return (NULL);
+}
+
+/**
+ * @brief	Fork-join evaluation of the DAG.
+ * 			Nodes are grouped by depth: every node of a level only depends on
+ * 			lower levels, so a level can be split freely between threads.
+ * 			Levels narrower than PARALLEL_MIN_WIDTH run on the calling thread.
+ * 			Failures are only recorded while computing; once everything is
+ * 			done, the failing node that comes first in the input is the one
+ * 			reported, which is what the sequential evaluation would raise.
+ * 
+ * @param	threads The maximum number of threads to use.
+ * @return	The value of the expression.
+ */
+template <typename T>
+T	RPNProgram::executeParallel(unsigned int threads) const
+{
+	std::vector<T>			values(_code.size());
+	std::vector<char>		state(_code.size(), 0);
+	std::vector<size_t>		depth(_code.size(), 0);
+	std::vector<size_t>		start(1, 0);
+	std::vector<size_t>		order(_code.size());
+	std::vector<pthread_t>	tids(threads);
+	std::vector<Worker<T> >	workers(threads);
+
+	// Counting sort of the nodes by level, keeping input order inside a level
+	for (size_t i = 0; i < _code.size(); ++i)
+	{
+		if (_code[i].op != PUSH)
+			depth[i] = std::max(depth[_code[i].left], depth[_code[i].right]) + 1;
+		if (depth[i] + 1 >= start.size())
+			start.resize(depth[i] + 2, 0);
+		start[depth[i] + 1]++;
+	}
+	for (size_t level = 1; level < start.size(); ++level)
+		start[level] += start[level - 1];
+	std::vector<size_t>	fill(start);
+	for (size_t i = 0; i < _code.size(); ++i)
+		order[fill[depth[i]]++] = i;
+
+	for (size_t level = 0; level + 1 < start.size(); ++level)
+	{
+		size_t	width = start[level + 1] - start[level];
+		if (width < PARALLEL_MIN_WIDTH)
+		{
+			for (size_t i = start[level]; i < start[level + 1]; ++i)
+				evaluateNode(order[i], values, state);
+			continue ;
+		}
+		size_t				used = std::min<size_t>(threads, width / (PARALLEL_MIN_WIDTH / 4));
+		size_t				slice = (width + used - 1) / used;
+		std::vector<char>	spawned(used, 0);
+		bool				outOfMemory = false;
+		for (size_t t = 0; t < used; ++t)
+		{
+			workers[t].program = this;
+			workers[t].values = &values;
+			workers[t].state = &state;
+			workers[t].nodes = &order[start[level] + t * slice];
+			workers[t].count = std::min(slice, width - t * slice);
+			workers[t].outOfMemory = false;
+			if (t == 0 || pthread_create(&tids[t], NULL, runWorker<T>, &workers[t]) != 0)
+				continue ;
+			spawned[t] = 1;
+		}
+		// Slice 0 and any slice whose thread could not start run here
+		for (size_t t = 0; t < used; ++t)
+		{
+			if (!spawned[t])
+				runWorker<T>(&workers[t]);
+		}
+		for (size_t t = 1; t < used; ++t)
+		{
+			if (spawned[t])
+				pthread_join(tids[t], NULL);
+			outOfMemory |= workers[t].outOfMemory;
+		}
+		if (outOfMemory || workers[0].outOfMemory)
+			throw std::bad_alloc();
+	}
+	for (size_t i = 0; i < _code.size(); ++i)
+	{
+		if (state[i] == 1)
+			throw std::invalid_argument("Division by zero.");
+	}
+	raiseFailure();
+	return (values[_result]);
+}
+
+/**
+ * @brief	Get the DAG nodes, in topological order.
+ * 
+ * @return	A constant reference to the node list.
+ */
+std::vector<RPNProgram::Instruction> const	&RPNProgram::getCode() const
+{
+	return (_code);
+}
+
+/**
+ * @brief	Get the node holding the value of the expression, meaningful
+ * 			only when the program has no failure.
+ */
+size_t	RPNProgram::getResult() const
+{
+	return (_result);
+}
+
+/**
+ * @brief	Get the structural error the program ends with, NONE if it is
+ * 			well formed.
+ */
+RPNProgram::Failure	RPNProgram::getFailure() const
+{
+	return (_failure);
+}
+
+/**
+ * @brief	Get the number of operators in the source expression, before
+ * 			deduplication and simplification.
+ */
+size_t	RPNProgram::getOperationCount() const
+{
+	return (_operations);
+}
+
+/**
+ * @brief	Whether the program was compiled for a value type with signed
+ * 			zeros, keeping the additions of 0.
+ */
+bool	RPNProgram::keepsSignedZeros() const
+{
+	return (_signedZeros);
+}
+
+template BigInt		RPNProgram::execute<BigInt>(unsigned int threads) const;
+template double		RPNProgram::execute<double>(unsigned int threads) const;
+template Rational	RPNProgram::execute<Rational>(unsigned int threads) const;
+template Decimal	RPNProgram::execute<Decimal>(unsigned int threads) const;
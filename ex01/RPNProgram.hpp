@@ -0,0 +1,121 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   RPNProgram.hpp                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: benpicar <benpicar@student.42mulhouse.fr>  +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 12:31:37 by benpicar          #+#    #+#             */
+/*   Updated: 2026/10/19 12:39:10 by benpicar         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma once
+
+#ifndef RPNPROGRAM_HPP
+# define RPNPROGRAM_HPP
+
+# include <vector>
+# include <algorithm>
+# include <cctype>
+# include <pthread.h>
+# include "Arithmetic.hpp"
+
+/* Smallest DAG level worth handing out to worker threads */
+# define PARALLEL_MIN_WIDTH 4096
+
+/**
+ * @brief	Validated, optimized form of an RPN expression.
+ * 			The expression is parsed once into an expression DAG stored in
+ * 			topological order. Identical subtrees are hash-consed into a
+ * 			single node, so a repeated subexpression is computed once, and
+ * 			neutral operations such as "x 1 *" or "x 0 +" are dropped.
+ * 			Every remaining node is evaluated exactly once in the order it
+ * 			first appears in the input, and a malformed expression keeps its
+ * 			valid prefix plus the failure it ends with, so errors (division by
+ * 			zero included) are raised in the same order as the streaming
+ * 			evaluator of RPN.
+ */
+class RPNProgram
+{
+	public:
+		enum OpCode
+		{
+			PUSH,
+			ADD,
+			SUB,
+			MUL,
+			DIV
+		};
+
+		enum Failure
+		{
+			NONE,
+			BAD_FORMAT,
+			BAD_CHARACTER,
+			MISSING_OPERANDS,
+			TOO_MANY_OPERANDS
+		};
+
+		struct Instruction
+		{
+			OpCode	op;
+			int		value;
+			size_t	left;
+			size_t	right;
+		};
+
+		template <typename T>
+		struct Worker
+		{
+			const RPNProgram	*program;
+			std::vector<T>		*values;
+			std::vector<char>	*state;
+			const size_t		*nodes;
+			size_t				count;
+			bool				outOfMemory;
+		};
+
+	private:
+		std::vector<Instruction>	_code;
+		std::vector<size_t>			_table;
+		std::vector<size_t>			_stack;
+		size_t						_operations;
+		size_t						_result;
+		Failure						_failure;
+		bool						_signedZeros;
+
+		bool		isLiteral(size_t node, int value) const;
+		size_t		hash(OpCode op, int value, size_t left, size_t right) const;
+		void		growTable();
+		size_t		intern(OpCode op, int value, size_t left, size_t right);
+		size_t		reduce(OpCode op, size_t left, size_t right);
+
+		void		raiseFailure() const;
+		template <typename T>
+		bool		evaluateNode(size_t i, std::vector<T> &values,
+						std::vector<char> &state) const;
+		template <typename T>
+		T			executeParallel(unsigned int threads) const;
+		template <typename T>
+		static void	*runWorker(void *arg);
+
+	public:
+		RPNProgram();
+		RPNProgram(const RPNProgram &origin);
+		RPNProgram	&operator=(const RPNProgram &other);
+		~RPNProgram();
+
+		void		compile(char **expressions, int length, bool signedZeros = false);
+		void		clear();
+		template <typename T>
+		T			execute(unsigned int threads = 1) const;
+
+		std::vector<Instruction> const	&getCode() const;
+		size_t		getResult() const;
+		Failure		getFailure() const;
+		size_t		getOperationCount() const;
+		bool		keepsSignedZeros() const;
+};
+
+#endif
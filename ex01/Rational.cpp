@@ -0,0 +1,144 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   Rational.cpp                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: benpicar <benpicar@student.42mulhouse.fr>  +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 12:38:10 by benpicar          #+#    #+#             */
+/*   Updated: 2026/10/19 12:39:10 by benpicar         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "Rational.hpp"
+
+/**
+ * @brief	Default constructor for Rational, initialized to zero.
+ */
+Rational::Rational() : _num(0), _den(1)
+{}
+
+/**
+ * @brief	Constructor from an integer.
+ * 
+ * @param	value The initial value.
+ */
+Rational::Rational(long long value) : _num(value), _den(1)
+{}
+
+/**
+ * @brief	Constructor from a numerator and a denominator.
+ * 
+ * @throws	std::invalid_argument if the denominator is zero.
+ */
+Rational::Rational(const BigInt &num, const BigInt &den) : _num(num), _den(den)
+{
+	if (_den.isZero())
+		throw std::invalid_argument("Division by zero.");
+	normalize();
+}
+
+/**
+ * @brief	Copy constructor for Rational.
+ * 
+ * @param	origin The Rational object to copy from.
+ */
+Rational::Rational(const Rational &origin) : _num(origin._num), _den(origin._den)
+{}
+
+/**
+ * @brief	Assignment operator for Rational.
+ * 
+ * @param	other The Rational object to assign from.
+ * @return	A reference to the current Rational object.
+ */
+Rational	&Rational::operator=(const Rational &other)
+{
+	if (this != &other)
+	{
+		_num = other._num;
+		_den = other._den;
+	}
+	return (*this);
+}
+
+/**
+ * @brief	Destructor for Rational.
+ */
+Rational::~Rational()
+{}
+
+/**
+ * @brief	Reduce the fraction and move the sign to the numerator.
+ */
+void	Rational::normalize()
+{
+	if (_den.isNegative())
+	{
+		_num = -_num;
+		_den = -_den;
+	}
+	BigInt	divisor = gcd(_num, _den);
+	if (divisor != BigInt(1))
+	{
+		_num = _num / divisor;
+		_den = _den / divisor;
+	}
+}
+
+Rational	Rational::operator+(const Rational &other) const
+{
+	if (_den == other._den)
+		return (Rational(_num + other._num, _den));
+	return (Rational(_num * other._den + other._num * _den, _den * other._den));
+}
+
+Rational	Rational::operator-(const Rational &other) const
+{
+	if (_den == other._den)
+		return (Rational(_num - other._num, _den));
+	return (Rational(_num * other._den - other._num * _den, _den * other._den));
+}
+
+Rational	Rational::operator*(const Rational &other) const
+{
+	return (Rational(_num * other._num, _den * other._den));
+}
+
+/**
+ * @throws	std::invalid_argument on division by zero.
+ */
+Rational	Rational::operator/(const Rational &other) const
+{
+	return (Rational(_num * other._den, _den * other._num));
+}
+
+/**
+ * @brief	Check if the value is zero.
+ */
+bool	Rational::isZero() const
+{
+	return (_num.isZero());
+}
+
+BigInt const	&Rational::getNumerator() const
+{
+	return (_num);
+}
+
+BigInt const	&Rational::getDenominator() const
+{
+	return (_den);
+}
+
+/**
+ * @brief	Output stream operator for Rational, as "num/den" or just "num"
+ * 			for integers.
+ */
+std::ostream	&operator<<(std::ostream &os, const Rational &value)
+{
+	os << value.getNumerator();
+	if (value.getDenominator() != BigInt(1))
+		os << "/" << value.getDenominator();
+	return (os);
+}
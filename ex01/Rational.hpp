@@ -0,0 +1,53 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   Rational.hpp                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: benpicar <benpicar@student.42mulhouse.fr>  +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 12:38:10 by benpicar          #+#    #+#             */
+/*   Updated: 2026/10/19 12:39:10 by benpicar         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma once
+
+#ifndef RATIONAL_HPP
+# define RATIONAL_HPP
+
+# include <iostream>
+# include "BigInt.hpp"
+
+/**
+ * @brief	Exact fraction of two BigInt, always kept reduced with a positive
+ * 			denominator, so equal values share one representation.
+ */
+class Rational
+{
+	private:
+		BigInt	_num;
+		BigInt	_den;
+
+		void	normalize();
+
+	public:
+		Rational();
+		Rational(long long value);
+		Rational(const BigInt &num, const BigInt &den);
+		Rational(const Rational &origin);
+		Rational	&operator=(const Rational &other);
+		~Rational();
+
+		Rational	operator+(const Rational &other) const;
+		Rational	operator-(const Rational &other) const;
+		Rational	operator*(const Rational &other) const;
+		Rational	operator/(const Rational &other) const;
+
+		bool		isZero() const;
+		BigInt const	&getNumerator() const;
+		BigInt const	&getDenominator() const;
+};
+
+std::ostream	&operator<<(std::ostream &os, const Rational &value);
+
+#endif
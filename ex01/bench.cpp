@@ -0,0 +1,395 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   bench.cpp                                          :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: benpicar <benpicar@student.42mulhouse.fr>  +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 12:39:58 by benpicar          #+#    #+#             */
+/*   Updated: 2026/10/19 12:39:58 by benpicar         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "RPN.hpp"
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <ctime>
+
+/*
+ * Benchmark and differential checker for the RPN evaluators.
+ * Random programs are generated, evaluated with every strategy and compared
+ * with the streaming reference (RPN::STACK): results and error messages must
+ * be identical. A few wide programs, balanced trees whose DAG is large
+ * enough for RPNProgram::executeParallel, are checked the same way.
+ * Throughput and latency percentiles are then reported per strategy,
+ * separately for valid programs, failing ones and wide ones. The cached
+ * strategy goes through the memoization cache, sized by --cache: it is
+ * checked over two passes, the second one replaying the cached outcomes,
+ * and --rounds evaluates the programs that many times to measure
+ * repetitive traffic.
+ */
+
+# define GREEN	"\033[0;92m"
+# define RED	"\033[0;91m"
+# define NC		"\033[0m"
+
+/* Share of valid programs turned into a signed zero plus a literal 0 */
+# define SIGNED_ZERO_PERCENT 5
+
+/* Height of the wide programs: 2^15 digits, levels of 8192 and 4096 nodes */
+# define WIDE_HEIGHT 15
+
+enum Kind
+{
+	VALID,
+	FAILING,
+	WIDE,
+	KINDS
+};
+
+struct Options
+{
+	size_t			length;
+	size_t			depth;
+	size_t			programs;
+	size_t			wide;
+	unsigned int	invalid;
+	unsigned int	division;
+	unsigned int	seed;
+	unsigned int	threads;
+	RPN::ValueType	type;
+	size_t			rounds;
+	size_t			cache;
+};
+
+struct Strategy
+{
+	const char		*name;
+	RPN::Strategy	strategy;
+	unsigned int	threads;
+	size_t			cache;
+};
+
+/**
+ * @brief	Small deterministic generator (xorshift), so a seed always gives
+ * 			the same programs whatever the libc.
+ */
+static unsigned int	nextRandom(unsigned int &state)
+{
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+	return (state);
+}
+
+static char	randomOperator(const Options &opt, unsigned int &state)
+{
+	static const char	ops[] = "+-*";
+
+	if (nextRandom(state) % 100 < opt.division)
+		return ('/');
+	return (ops[nextRandom(state) % 3]);
+}
+
+/**
+ * @brief	Generate a random RPN program.
+ * 			A valid program has about length tokens and never holds more than
+ * 			depth operands. A few become P 0 * 0 + or 0 P 0 * +, which is -0
+ * 			plus 0 with doubles when P is negative, and must give +0.
+ * 			Invalid programs get one defect: a bad character,
+ * 			two glued tokens, a missing operand or a leftover operand.
+ * 			Division by zero can happen in both kinds, its frequency follows
+ * 			the share of '/' operators.
+ */
+static std::string	generateProgram(const Options &opt, unsigned int &state)
+{
+	std::vector<std::string>	tokens;
+	size_t						depth = 0;
+	size_t						maxDepth = std::max<size_t>(opt.depth, 2);
+
+	while (tokens.size() < opt.length || depth > 1)
+	{
+		bool	push = depth < 2 || (depth < maxDepth && tokens.size() < opt.length
+			&& nextRandom(state) % 2 == 0);
+		if (push)
+		{
+			tokens.push_back(std::string(1, static_cast<char>('0' + nextRandom(state) % 10)));
+			depth++;
+		}
+		else
+		{
+			tokens.push_back(std::string(1, randomOperator(opt, state)));
+			depth--;
+		}
+	}
+	if (nextRandom(state) % 100 < SIGNED_ZERO_PERCENT)
+	{
+		bool	front = nextRandom(state) % 2 == 0;
+
+		if (front)
+			tokens.insert(tokens.begin(), std::string("0"));
+		tokens.push_back("0");
+		tokens.push_back("*");
+		if (!front)
+			tokens.push_back("0");
+		tokens.push_back("+");
+	}
+	if (nextRandom(state) % 100 < opt.invalid)
+	{
+		size_t	pos = nextRandom(state) % tokens.size();
+		switch (nextRandom(state) % 4)
+		{
+			case (0):
+				tokens[pos] = std::string(1, "x(.%"[nextRandom(state) % 4]);
+				break ;
+			case (1):
+				tokens[pos] += "1";
+				break ;
+			case (2):
+				tokens.insert(tokens.begin() + pos, std::string(1, randomOperator(opt, state)));
+				break ;
+			default:
+				tokens.push_back("7");
+				break ;
+		}
+	}
+	std::string	program;
+	for (size_t i = 0; i < tokens.size(); ++i)
+	{
+		if (i)
+			program += ' ';
+		program += tokens[i];
+	}
+	return (program);
+}
+
+/**
+ * @brief	Append a balanced program of the given height: two programs of
+ * 			height - 1 and an operator, a digit at height 0. Once hash-
+ * 			consed, its lower levels are as wide as the program allows, so
+ * 			a parallel evaluation splits them between threads. There is no
+ * 			division: one by a zero subtree is nearly certain in so many
+ * 			operators, and would make the program fail instead.
+ */
+static void	generateWide(unsigned int &state, size_t height, std::string &program)
+{
+	if (height == 0)
+	{
+		program += static_cast<char>('0' + nextRandom(state) % 10);
+		program += ' ';
+		return ;
+	}
+	generateWide(state, height - 1, program);
+	generateWide(state, height - 1, program);
+	program += "+-*"[nextRandom(state) % 3];
+	program += ' ';
+}
+
+/**
+ * @brief	Evaluate a program, turning errors into their message so outcomes
+ * 			of different strategies can be compared.
+ */
+static std::string	run(RPN &rpn, const std::string &program)
+{
+	std::vector<char>	buffer(program.begin(), program.end());
+	char				*expressions[1];
+
+	buffer.push_back('\0');
+	expressions[0] = &buffer[0];
+	try
+	{
+		return (rpn.evaluateToString(expressions, 1));
+	}
+	catch (const std::exception &e)
+	{
+		return (std::string("Error: ") + e.what());
+	}
+}
+
+/**
+ * @brief	Monotonic wall clock, in nanoseconds.
+ */
+static double	now()
+{
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec * 1e9 + ts.tv_nsec);
+}
+
+static double	percentile(std::vector<double> &sorted, double p)
+{
+	size_t	idx = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+
+	return (sorted[idx]);
+}
+
+static bool	parseOption(const std::string &arg, const char *name, unsigned long &value)
+{
+	std::string	prefix = std::string("--") + name + "=";
+
+	if (arg.compare(0, prefix.length(), prefix) != 0)
+		return (false);
+	value = std::strtoul(arg.c_str() + prefix.length(), NULL, 10);
+	return (true);
+}
+
+static bool	parseOptions(int ac, char **av, Options &opt)
+{
+	unsigned long	value;
+
+	for (int i = 1; i < ac; ++i)
+	{
+		std::string	arg(av[i]);
+		if (parseOption(arg, "length", value))
+			opt.length = std::max<size_t>(value, 1);
+		else if (parseOption(arg, "depth", value))
+			opt.depth = value;
+		else if (parseOption(arg, "programs", value))
+			opt.programs = std::max<size_t>(value, 1);
+		else if (parseOption(arg, "wide", value))
+			opt.wide = value;
+		else if (parseOption(arg, "invalid", value))
+			opt.invalid = static_cast<unsigned int>(std::min<unsigned long>(value, 100));
+		else if (parseOption(arg, "division", value))
+			opt.division = static_cast<unsigned int>(std::min<unsigned long>(value, 100));
+		else if (parseOption(arg, "seed", value))
+			opt.seed = static_cast<unsigned int>(value ? value : 1);
+		else if (parseOption(arg, "rounds", value))
+			opt.rounds = std::max<size_t>(value, 1);
+		else if (parseOption(arg, "cache", value))
+			opt.cache = value;
+		else if (parseOption(arg, "threads", value))
+			opt.threads = static_cast<unsigned int>(std::max<unsigned long>(value, 2));
+		else if (arg == "--type=integer")
+			opt.type = RPN::INTEGER;
+		else if (arg == "--type=double")
+			opt.type = RPN::FLOATING;
+		else if (arg == "--type=rational")
+			opt.type = RPN::RATIONAL;
+		else if (arg == "--type=decimal")
+			opt.type = RPN::DECIMAL;
+		else
+			return (false);
+	}
+	return (true);
+}
+
+int	main(int ac, char **av)
+{
+	Options		opt = {1000, 16, 200, 2, 10, 1, 42, 4, RPN::INTEGER, 1, CACHE_DEFAULT_BYTES};
+
+	if (!parseOptions(ac, av, opt))
+	{
+		std::cerr << "Usage: " << av[0] << " [--length=N] [--depth=N] [--programs=N] [--wide=N]"
+				  << " [--invalid=PERCENT] [--division=PERCENT] [--seed=N] [--threads=N]"
+				  << " [--type=integer|double|rational|decimal] [--rounds=N] [--cache=BYTES]"
+				  << std::endl;
+		return (1);
+	}
+
+	const Strategy	strategies[] = {
+		{"stack", RPN::STACK, 1, 0},
+		{"compiled", RPN::COMPILED, 1, 0},
+		{"parallel", RPN::COMPILED, opt.threads, 0},
+		{"cached", RPN::COMPILED, 1, opt.cache},
+		{"native", RPN::NATIVE, 1, 0}
+	};
+	const size_t	count = sizeof(strategies) / sizeof(strategies[0]);
+
+	static const char			*kindNames[KINDS] = {"valid", "failing", "wide"};
+	std::vector<std::string>	programs;
+	size_t						tokens = 0;
+	unsigned int				state = opt.seed;
+	for (size_t i = 0; i < opt.programs + opt.wide; ++i)
+	{
+		if (i < opt.programs)
+			programs.push_back(generateProgram(opt, state));
+		else
+		{
+			programs.push_back(std::string());
+			generateWide(state, WIDE_HEIGHT, programs.back());
+			programs.back().erase(programs.back().length() - 1);
+		}
+		tokens += (programs.back().length() + 1) / 2;
+	}
+
+	// Differential check against the streaming reference
+	std::vector<std::string>	expected(programs.size());
+	std::vector<Kind>			kinds(programs.size());
+	size_t						kindTokens[KINDS] = {0, 0, 0};
+	size_t						errors = 0;
+	size_t						mismatches = 0;
+	RPN							reference;
+	reference.setStrategy(RPN::STACK);
+	reference.setValueType(opt.type);
+	for (size_t i = 0; i < programs.size(); ++i)
+	{
+		expected[i] = run(reference, programs[i]);
+		kinds[i] = i >= opt.programs ? WIDE : VALID;
+		if (expected[i].compare(0, 7, "Error: ") == 0)
+		{
+			errors++;
+			if (kinds[i] == VALID)
+				kinds[i] = FAILING;
+		}
+		kindTokens[kinds[i]] += (programs[i].length() + 1) / 2;
+	}
+	for (size_t s = 1; s < count; ++s)
+	{
+		RPN	rpn;
+		rpn.setStrategy(strategies[s].strategy);
+		rpn.setThreads(strategies[s].threads);
+		rpn.setValueType(opt.type);
+		rpn.setCacheSize(strategies[s].cache);
+		for (size_t i = 0; i < programs.size() * (strategies[s].cache ? 2 : 1); ++i)
+		{
+			std::string	got = run(rpn, programs[i % programs.size()]);
+			if (got == expected[i % programs.size()])
+				continue ;
+			if (++mismatches <= 5)
+				std::cerr << RED << "Mismatch (" << strategies[s].name << "): "
+						  << programs[i % programs.size()].substr(0, 200)
+						  << "\n  expected: " << expected[i % programs.size()]
+						  << "\n  got:      " << got << NC << std::endl;
+		}
+	}
+	std::cout << programs.size() << " programs (" << opt.wide << " wide), " << tokens
+			  << " tokens, " << errors << " error outcomes, " << mismatches << " mismatches"
+			  << std::endl;
+
+	// Benchmark
+	for (size_t s = 0; s < count; ++s)
+	{
+		RPN					rpn;
+		std::vector<double>	latencies[KINDS];
+		double				total[KINDS] = {0, 0, 0};
+
+		rpn.setStrategy(strategies[s].strategy);
+		rpn.setThreads(strategies[s].threads);
+		rpn.setValueType(opt.type);
+		rpn.setCacheSize(strategies[s].cache);
+		for (size_t i = 0; i < programs.size() * opt.rounds; ++i)
+		{
+			Kind	kind = kinds[i % programs.size()];
+			double	start = now();
+			run(rpn, programs[i % programs.size()]);
+			latencies[kind].push_back(now() - start);
+			total[kind] += latencies[kind].back();
+		}
+		for (size_t k = 0; k < KINDS; ++k)
+		{
+			if (latencies[k].empty())
+				continue ;
+			std::sort(latencies[k].begin(), latencies[k].end());
+			std::cout << GREEN << strategies[s].name << NC << " (" << kindNames[k] << "): "
+					  << static_cast<long long>(kindTokens[k] * opt.rounds / (total[k] / 1e9))
+					  << " tokens/s"
+					  << ", p50 " << percentile(latencies[k], 0.50) / 1000.0 << " us"
+					  << ", p90 " << percentile(latencies[k], 0.90) / 1000.0 << " us"
+					  << ", p99 " << percentile(latencies[k], 0.99) / 1000.0 << " us" << std::endl;
+		}
+	}
+	return (mismatches == 0 ? 0 : 1);
+}
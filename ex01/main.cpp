@@ -6,29 +6,74 @@
 /*   By: benpicar <benpicar@student.42mulhouse.fr>  +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/06/20 14:57:53 by benpicar          #+#    #+#             */
-/*   Updated: 2025/06/20 16:15:48 by benpicar         ###   ########.fr       */
+/*   Updated: 2026/10/19 12:39:10 by benpicar         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "RPN.hpp"
+#include "Profiler.hpp"
 
 int	main(int ac, char **av)
 {
-	RPN	rpn;
+	RPN		rpn;
+	int		first = 1;
+	bool	batch = false;
+	long	cache = -1;
 
-	if (ac < 2)
+	while (ac > first && std::string(av[first]).compare(0, 2, "--") == 0)
 	{
-		std::cerr << "Usage: " << av[0] << " <expression>" << std::endl;
+		std::string	option(av[first]);
+		if (option == "--stack")
+			rpn.setStrategy(RPN::STACK);
+		else if (option == "--native")
+			rpn.setStrategy(RPN::NATIVE);
+		else if (option == "--type=integer")
+			rpn.setValueType(RPN::INTEGER);
+		else if (option == "--type=double")
+			rpn.setValueType(RPN::FLOATING);
+		else if (option == "--type=rational")
+			rpn.setValueType(RPN::RATIONAL);
+		else if (option == "--type=decimal")
+			rpn.setValueType(RPN::DECIMAL);
+		else if (option.compare(0, 10, "--threads=") == 0)
+			rpn.setThreads(static_cast<unsigned int>(std::strtoul(option.c_str() + 10, NULL, 10)));
+		else if (option == "--profile")
+			Profiler::enable();
+		else if (option == "--batch")
+			batch = true;
+		else if (option.compare(0, 8, "--cache=") == 0)
+			cache = std::strtol(option.c_str() + 8, NULL, 10);
+		else
+			break ;
+		first++;
+	}
+	if (ac <= first && !batch)
+	{
+		std::cerr << "Usage: " << av[0] << " [--stack|--native] [--threads=N] [--profile] [--cache=BYTES]"
+				  << " [--type=integer|double|rational|decimal] <expression> | --batch" << std::endl;
 		return (1);
 	}
+	if (cache >= 0 || batch)
+		rpn.setCacheSize(cache >= 0 ? static_cast<size_t>(cache) : CACHE_DEFAULT_BYTES);
+	if (batch)
+	{
+		size_t	failures = rpn.evaluateStream(std::cin, std::cout);
+
+		if (Profiler::isEnabled())
+			rpn.getCache().report(std::cerr);
+		Profiler::report(std::cerr);
+		return (failures == 0 ? 0 : 1);
+	}
 	try
 	{
-		rpn.evaluateExpression(&av[1], ac - 1);
+		rpn.evaluateExpression(&av[first], ac - first);
 	}
 	catch (const std::exception &e)
 	{
 		std::cerr << "Error: " << e.what() << std::endl;
+		Profiler::report(std::cerr);
 		return (1);
 	}
+	Profiler::report(std::cerr);
 	return (0);
 }
@@ -0,0 +1,208 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   BlockChain.cpp                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: benpicar <benpicar@student.42mulhouse.fr>  +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 12:43:06 by benpicar          #+#    #+#             */
+/*   Updated: 2026/10/19 12:43:06 by benpicar         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "BlockChain.hpp"
+
+/**
+ * @brief	Default constructor for BlockChain, without storage.
+ */
+BlockChain::BlockChain() : _slots(NULL), _order(NULL), _sizes(NULL), _prefix(NULL),
+	_blockSize(0), _maxBlocks(0), _blocks(0)
+{}
+
+/**
+ * @brief	Copy constructor for BlockChain. The copy shares the arena.
+ * 
+ * @param	origin The BlockChain object to copy from.
+ */
+BlockChain::BlockChain(const BlockChain &origin) : _slots(origin._slots),
+	_order(origin._order), _sizes(origin._sizes), _prefix(origin._prefix),
+	_blockSize(origin._blockSize), _maxBlocks(origin._maxBlocks), _blocks(origin._blocks)
+{}
+
+/**
+ * @brief	Assignment operator for BlockChain. The copy shares the arena.
+ * 
+ * @param	other The BlockChain object to assign from.
+ * @return	A reference to the current BlockChain object.
+ */
+BlockChain	&BlockChain::operator=(const BlockChain &other)
+{
+	if (this != &other)
+	{
+		_slots = other._slots;
+		_order = other._order;
+		_sizes = other._sizes;
+		_prefix = other._prefix;
+		_blockSize = other._blockSize;
+		_maxBlocks = other._maxBlocks;
+		_blocks = other._blocks;
+	}
+	return (*this);
+}
+
+/**
+ * @brief	Destructor for BlockChain. The arena belongs to the caller.
+ */
+BlockChain::~BlockChain()
+{}
+
+/**
+ * @brief	Block size for a chain: a power of two around the square root
+ * 			of the capacity, which balances the in-block shift against the
+ * 			prefix update done on every insertion.
+ */
+size_t	BlockChain::blockSizeFor(size_t capacity)
+{
+	size_t	blockSize = 64;
+
+	while (blockSize * blockSize < capacity)
+		blockSize *= 2;
+	return (blockSize);
+}
+
+/**
+ * @brief	Number of size_t needed in the arena for a given capacity.
+ * 			Blocks are at least half full after a split, so capacity /
+ * 			(blockSize / 2) + 2 blocks are always enough.
+ */
+size_t	BlockChain::arenaSize(size_t capacity)
+{
+	size_t	blockSize = blockSizeFor(capacity);
+	size_t	maxBlocks = capacity / (blockSize / 2) + 2;
+
+	return (maxBlocks * blockSize + 3 * maxBlocks + 1);
+}
+
+/**
+ * @brief	Give the chain its storage.
+ * 
+ * @param	arena At least arenaSize(capacity) elements.
+ * @param	capacity The maximum number of elements the chain will hold.
+ */
+void	BlockChain::setArena(size_t *arena, size_t capacity)
+{
+	_blockSize = blockSizeFor(capacity);
+	_maxBlocks = capacity / (_blockSize / 2) + 2;
+	_slots = arena;
+	_order = _slots + _maxBlocks * _blockSize;
+	_sizes = _order + _maxBlocks;
+	_prefix = _sizes + _maxBlocks;
+	_blocks = 0;
+}
+
+/**
+ * @brief	Replace the content of the chain, filling blocks half way to
+ * 			leave room for insertions.
+ */
+void	BlockChain::assign(const size_t *src, size_t count)
+{
+	size_t	fill = _blockSize / 2;
+
+	_blocks = 0;
+	_prefix[0] = 0;
+	for (size_t done = 0; done < count || _blocks == 0; ++_blocks)
+	{
+		size_t	chunk = std::min(fill, count - done);
+		std::copy(src + done, src + done + chunk, _slots + _blocks * _blockSize);
+		_order[_blocks] = _blocks;
+		_sizes[_blocks] = chunk;
+		_prefix[_blocks + 1] = _prefix[_blocks] + chunk;
+		done += chunk;
+	}
+}
+
+/**
+ * @brief	Number of elements in the chain.
+ */
+size_t	BlockChain::size() const
+{
+	return (_prefix[_blocks]);
+}
+
+/**
+ * @brief	Logical block holding a position. A position at the end of a
+ * 			block belongs to that block, so appending never needs a new one.
+ */
+size_t	BlockChain::findBlock(size_t pos) const
+{
+	size_t	block = std::upper_bound(_prefix + 1, _prefix + _blocks + 1, pos) - (_prefix + 1);
+
+	return (block < _blocks ? block : _blocks - 1);
+}
+
+/**
+ * @brief	Element at a position.
+ */
+size_t	BlockChain::at(size_t pos) const
+{
+	size_t	block = findBlock(pos);
+
+	return (_slots[_order[block] * _blockSize + (pos - _prefix[block])]);
+}
+
+/**
+ * @brief	Split a full logical block in two, the upper half going to a
+ * 			fresh physical block placed right after it.
+ */
+void	BlockChain::split(size_t block)
+{
+	size_t	phys = _order[block];
+	size_t	fresh = _blocks;
+	size_t	half = _sizes[phys] / 2;
+
+	std::copy(_slots + phys * _blockSize + half, _slots + phys * _blockSize + _sizes[phys],
+		_slots + fresh * _blockSize);
+	_sizes[fresh] = _sizes[phys] - half;
+	_sizes[phys] = half;
+	std::copy_backward(_order + block + 1, _order + _blocks, _order + _blocks + 1);
+	std::copy_backward(_prefix + block + 1, _prefix + _blocks + 1, _prefix + _blocks + 2);
+	_order[block + 1] = fresh;
+	_prefix[block + 1] = _prefix[block] + half;
+	_blocks++;
+}
+
+/**
+ * @brief	Insert a value before the element at a position.
+ */
+void	BlockChain::insert(size_t pos, size_t value)
+{
+	size_t	block = findBlock(pos);
+
+	if (_sizes[_order[block]] == _blockSize)
+	{
+		split(block);
+		if (pos > _prefix[block + 1])
+			block++;
+	}
+	size_t	*base = _slots + _order[block] * _blockSize;
+	size_t	offset = pos - _prefix[block];
+	size_t	&count = _sizes[_order[block]];
+
+	std::copy_backward(base + offset, base + count, base + count + 1);
+	base[offset] = value;
+	count++;
+	for (size_t i = block + 1; i <= _blocks; ++i)
+		_prefix[i]++;
+}
+
+/**
+ * @brief	Copy the chain, in order, to a contiguous array.
+ */
+void	BlockChain::flatten(size_t *dest) const
+{
+	for (size_t block = 0; block < _blocks; ++block)
+	{
+		const size_t	*base = _slots + _order[block] * _blockSize;
+		dest = std::copy(base, base + _sizes[_order[block]], dest);
+	}
+}
@@ -0,0 +1,61 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   BlockChain.hpp                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: benpicar <benpicar@student.42mulhouse.fr>  +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 12:43:06 by benpicar          #+#    #+#             */
+/*   Updated: 2026/10/19 12:43:06 by benpicar         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma once
+
+#ifndef BLOCKCHAIN_HPP
+# define BLOCKCHAIN_HPP
+
+# include <cstddef>
+# include <algorithm>
+
+/**
+ * @brief	Sequence of indices with cheap insertion in the middle, used as
+ * 			the main chain of the vector merge-insertion.
+ * 			Elements live in fixed-size blocks: an insertion only shifts the
+ * 			tail of one block (splitting it when full) instead of the tail of
+ * 			the whole chain, and random access goes through the prefix sums
+ * 			of the block sizes. All storage comes from a caller-provided
+ * 			arena, so the chain never allocates.
+ */
+class BlockChain
+{
+	private:
+		size_t	*_slots;
+		size_t	*_order;
+		size_t	*_sizes;
+		size_t	*_prefix;
+		size_t	_blockSize;
+		size_t	_maxBlocks;
+		size_t	_blocks;
+
+		size_t	findBlock(size_t pos) const;
+		void	split(size_t block);
+
+	public:
+		BlockChain();
+		BlockChain(const BlockChain &origin);
+		BlockChain	&operator=(const BlockChain &other);
+		~BlockChain();
+
+		static size_t	blockSizeFor(size_t capacity);
+		static size_t	arenaSize(size_t capacity);
+
+		void	setArena(size_t *arena, size_t capacity);
+		void	assign(const size_t *src, size_t count);
+		size_t	size() const;
+		size_t	at(size_t pos) const;
+		void	insert(size_t pos, size_t value);
+		void	flatten(size_t *dest) const;
+};
+
+#endif
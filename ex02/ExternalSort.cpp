@@ -0,0 +1,294 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   ExternalSort.cpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: benpicar <benpicar@student.42mulhouse.fr>  +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 15:20:03 by benpicar          #+#    #+#             */
+/*   Updated: 2026/10/19 15:20:03 by benpicar         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "ExternalSort.hpp"
+#include <stdexcept>
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+/**
+ * @brief	Default constructor for RunReader, not attached to a run.
+ */
+RunReader::RunReader() : fd(-1), offset(0), end(0), pos(0), length(0)
+{}
+
+/**
+ * @brief	Constructor for ExternalSort. Runs go to $TMPDIR, or /tmp.
+ *
+ * @param	memory The bytes the merge may spend on read and write buffers.
+ */
+ExternalSort::ExternalSort(size_t memory) : _memory(memory), _file(-1), _count(0)
+{
+	const char	*dir = std::getenv("TMPDIR");
+
+	_tempDir = (dir != NULL && *dir != '\0') ? dir : "/tmp";
+}
+
+/**
+ * @brief	Destructor for ExternalSort, closing (and so deleting) the runs
+ * 			left.
+ */
+ExternalSort::~ExternalSort()
+{
+	if (_file >= 0)
+		close(_file);
+}
+
+/**
+ * @brief	Create an anonymous temporary file for the runs.
+ *
+ * @return	The descriptor of the file, already unlinked.
+ * @throws	std::runtime_error if the file cannot be created.
+ */
+int	ExternalSort::createFile() const
+{
+	std::string			path = _tempDir + "/pmergeme.XXXXXX";
+	std::vector<char>	name(path.begin(), path.end());
+
+	name.push_back('\0');
+	int	fd = mkstemp(&name[0]);
+	if (fd < 0)
+		throw std::runtime_error("Cannot create a run in " + _tempDir + " : " + std::strerror(errno));
+	unlink(&name[0]);
+	return (fd);
+}
+
+/**
+ * @brief	Spill one sorted run.
+ *
+ * @param	values The sorted values.
+ * @param	count The number of values.
+ * @throws	std::runtime_error if the run cannot be written.
+ */
+void	ExternalSort::addRun(const unsigned int *values, size_t count)
+{
+	if (count == 0)
+		return ;
+
+	if (_file < 0)
+		_file = createFile();
+	writeAll(_file, reinterpret_cast<const char *>(values), count * sizeof(unsigned int));
+	_runs.push_back(static_cast<off_t>(_count * sizeof(unsigned int)));
+	_count += count;
+}
+
+/**
+ * @brief	Number of runs spilled so far.
+ */
+size_t	ExternalSort::runCount() const
+{
+	return (_runs.size());
+}
+
+/**
+ * @brief	Number of values spilled so far.
+ */
+unsigned long long	ExternalSort::size() const
+{
+	return (_count);
+}
+
+/**
+ * @brief	Offset in the file just past a run, which is where the next one
+ * 			starts.
+ */
+off_t	ExternalSort::runEnd(size_t run) const
+{
+	if (run + 1 < _runs.size())
+		return (_runs[run + 1]);
+	return (static_cast<off_t>(_count * sizeof(unsigned int)));
+}
+
+/**
+ * @brief	Read the next block of a run, and ask the kernel to start
+ * 			reading the block after it.
+ *
+ * @return	false once the run is exhausted.
+ * @throws	std::runtime_error on a read error.
+ */
+bool	ExternalSort::fill(RunReader &reader)
+{
+	char	*data = reinterpret_cast<char *>(&reader.buffer[0]);
+	size_t	block = reader.buffer.size() * sizeof(unsigned int);
+	size_t	bytes = std::min<off_t>(block, reader.end - reader.offset);
+	size_t	got = 0;
+
+	while (got < bytes)
+	{
+		ssize_t	done = pread(reader.fd, data + got, bytes - got, reader.offset + got);
+		if (done == 0)
+			break ;
+		if (done < 0)
+		{
+			if (errno == EINTR)
+				continue ;
+			throw std::runtime_error(std::string("Cannot read a run : ") + std::strerror(errno));
+		}
+		got += done;
+	}
+	reader.offset += got;
+	reader.pos = 0;
+	reader.length = got / sizeof(unsigned int);
+	if (reader.length > 0 && reader.offset < reader.end)
+	{
+		posix_fadvise(reader.fd, reader.offset,
+			std::min<off_t>(block, reader.end - reader.offset), POSIX_FADV_WILLNEED);
+	}
+	return (reader.length > 0);
+}
+
+/**
+ * @brief	Whether the head of run a comes before the head of run b. An
+ * 			exhausted run loses against every other.
+ */
+bool	ExternalSort::beats(size_t a, size_t b) const
+{
+	const RunReader	&left = _readers[a];
+	const RunReader	&right = _readers[b];
+
+	if (left.length == 0)
+		return (false);
+	if (right.length == 0)
+		return (true);
+	if (left.buffer[left.pos] != right.buffer[right.pos])
+		return (left.buffer[left.pos] < right.buffer[right.pos]);
+	return (a < b);
+}
+
+/**
+ * @brief	Play the initial tournament below a node, storing each match's
+ * 			loser in the node. Leaves are the nodes k to 2k - 1.
+ *
+ * @return	The run winning below the node.
+ */
+size_t	ExternalSort::build(size_t node)
+{
+	size_t	k = _readers.size();
+
+	if (node >= k)
+		return (node - k);
+
+	size_t	left = build(2 * node);
+	size_t	right = build(2 * node + 1);
+
+	if (beats(left, right))
+	{
+		_tree[node] = right;
+		return (left);
+	}
+	_tree[node] = left;
+	return (right);
+}
+
+/**
+ * @brief	Merge a group of consecutive runs into a buffer.
+ *
+ * @param	first The first run of the group.
+ * @param	last The run past the group.
+ * @param	out The buffer receiving the merged values.
+ * @param	text Whether values are written as text lines or raw.
+ */
+void	ExternalSort::mergeGroup(size_t first, size_t last, OutputBuffer &out, bool text)
+{
+	size_t	k = last - first;
+	size_t	block = std::max<size_t>(MERGE_MIN_BUFFER, _memory / (k + 1) / sizeof(unsigned int));
+
+	_readers.assign(k, RunReader());
+	for (size_t i = 0; i < k; ++i)
+	{
+		_readers[i].fd = _file;
+		_readers[i].offset = _runs[first + i];
+		_readers[i].end = runEnd(first + i);
+		_readers[i].buffer.resize(block);
+		fill(_readers[i]);
+	}
+	_tree.assign(k, 0);
+	_tree[0] = build(1);
+
+	while (true)
+	{
+		size_t		winner = _tree[0];
+		RunReader	&reader = _readers[winner];
+
+		if (reader.length == 0)
+			break ;
+		if (text)
+			out.putValue(reader.buffer[reader.pos], '\n');
+		else
+			out.putRaw(&reader.buffer[reader.pos], sizeof(unsigned int));
+		if (++reader.pos == reader.length)
+			fill(reader);
+		for (size_t node = (winner + k) / 2; node > 0; node /= 2)
+		{
+			if (beats(_tree[node], winner))
+				std::swap(_tree[node], winner);
+		}
+		_tree[0] = winner;
+	}
+	_readers.clear();
+}
+
+/**
+ * @brief	Merge every run into a descriptor. Runs are consumed.
+ *
+ * @param	fd The descriptor receiving the sorted values.
+ * @param	text Whether values are written one per line, or raw.
+ * @throws	std::runtime_error on an I/O error.
+ */
+void	ExternalSort::merge(int fd, bool text)
+{
+	size_t	outputSize = std::max<size_t>(OUTPUT_BUFFER_SIZE, _memory / (MERGE_FANIN + 1));
+
+	if (_runs.empty())
+		return ;
+	posix_fadvise(_file, 0, 0, POSIX_FADV_SEQUENTIAL);
+	while (_runs.size() > MERGE_FANIN)
+	{
+		std::vector<off_t>	next;
+		int					file = createFile();
+
+		try
+		{
+			OutputBuffer	out(file, outputSize);
+
+			for (size_t first = 0; first < _runs.size(); first += MERGE_FANIN)
+			{
+				size_t	last = std::min<size_t>(first + MERGE_FANIN, _runs.size());
+
+				/* The merged group takes the place its runs had in the file */
+				next.push_back(_runs[first]);
+				mergeGroup(first, last, out, false);
+			}
+			out.flush();
+		}
+		catch (...)
+		{
+			close(file);
+			throw ;
+		}
+		close(_file);
+		_file = file;
+		_runs.swap(next);
+		posix_fadvise(_file, 0, 0, POSIX_FADV_SEQUENTIAL);
+	}
+
+	OutputBuffer	out(fd, outputSize);
+	mergeGroup(0, _runs.size(), out, text);
+	out.flush();
+	close(_file);
+	_file = -1;
+	_runs.clear();
+}
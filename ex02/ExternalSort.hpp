@@ -0,0 +1,89 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   ExternalSort.hpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: benpicar <benpicar@student.42mulhouse.fr>  +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 15:20:03 by benpicar          #+#    #+#             */
+/*   Updated: 2026/10/19 15:20:03 by benpicar         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma once
+
+#ifndef EXTERNALSORT_HPP
+# define EXTERNALSORT_HPP
+
+# include <cstddef>
+# include <string>
+# include <vector>
+# include <sys/types.h>
+# include "OutputBuffer.hpp"
+
+/* Largest number of runs merged in one pass */
+# define MERGE_FANIN 128
+
+/* Smallest read buffer of a run during a merge, in values */
+# define MERGE_MIN_BUFFER 16384
+
+/**
+ * @brief	Sequential reader over one spilled run.
+ */
+struct RunReader
+{
+	int							fd;
+	off_t						offset;
+	off_t						end;
+	std::vector<unsigned int>	buffer;
+	size_t						pos;
+	size_t						length;
+
+	RunReader();
+};
+
+/**
+ * @brief	Spills sorted runs to a temporary file and merges them.
+ * 			Runs are raw unsigned int values appended one after the other
+ * 			to a single file, unlinked as soon as it is created, so
+ * 			nothing is left behind even on a crash, and the number of runs
+ * 			is not bounded by the descriptor limit.
+ * 			The merge is k-way through a loser tree: each output value
+ * 			costs one comparison per tree level, against the winner's path
+ * 			only. Every run is read in large blocks, the next block being
+ * 			announced to the kernel ahead of time. Beyond MERGE_FANIN runs,
+ * 			groups of runs are first merged into longer ones, written to a
+ * 			new file which then replaces the current one.
+ */
+class ExternalSort
+{
+	private:
+		std::string				_tempDir;
+		size_t					_memory;
+		int						_file;
+		std::vector<off_t>		_runs;
+		unsigned long long		_count;
+		std::vector<RunReader>	_readers;
+		std::vector<size_t>		_tree;
+
+		int		createFile() const;
+		bool	fill(RunReader &reader);
+		bool	beats(size_t a, size_t b) const;
+		size_t	build(size_t node);
+		off_t	runEnd(size_t run) const;
+		void	mergeGroup(size_t first, size_t last, OutputBuffer &out, bool text);
+
+		ExternalSort(const ExternalSort &origin);
+		ExternalSort	&operator=(const ExternalSort &other);
+
+	public:
+		ExternalSort(size_t memory);
+		~ExternalSort();
+
+		void				addRun(const unsigned int *values, size_t count);
+		size_t				runCount() const;
+		unsigned long long	size() const;
+		void				merge(int fd, bool text);
+};
+
+#endif
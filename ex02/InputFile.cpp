@@ -0,0 +1,233 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   InputFile.cpp                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: benpicar <benpicar@student.42mulhouse.fr>  +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 14:40:27 by benpicar          #+#    #+#             */
+/*   Updated: 2026/10/19 14:40:27 by benpicar         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "InputFile.hpp"
+#include <stdexcept>
+#include <cerrno>
+#include <cstring>
+#include <cctype>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/**
+ * @brief	Open and load an input. A regular file is mapped, anything else
+ * 			(standard input with "-", a pipe, a device) is read to its end.
+ *
+ * @param	path The path of the file, or "-" for standard input.
+ * @throws	std::runtime_error if the input cannot be opened or read.
+ */
+InputFile::InputFile(const std::string &path) : _data(NULL), _size(0), _mapping(NULL)
+{
+	int			fd = (path == "-") ? STDIN_FILENO : open(path.c_str(), O_RDONLY);
+	struct stat	info;
+
+	if (fd < 0)
+		throw std::runtime_error("Cannot open " + path + " : " + std::strerror(errno));
+	if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0)
+	{
+		void	*mapping = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (mapping != MAP_FAILED)
+		{
+			madvise(mapping, info.st_size, MADV_SEQUENTIAL);
+			_mapping = mapping;
+			_data = static_cast<const char *>(mapping);
+			_size = info.st_size;
+		}
+	}
+	try
+	{
+		if (_mapping == NULL)
+			readAll(fd);
+	}
+	catch (...)
+	{
+		if (fd != STDIN_FILENO)
+			close(fd);
+		throw ;
+	}
+	if (fd != STDIN_FILENO)
+		close(fd);
+}
+
+/**
+ * @brief	Destructor for InputFile, releasing the mapping if any.
+ */
+InputFile::~InputFile()
+{
+	if (_mapping != NULL)
+		munmap(_mapping, _size);
+}
+
+/**
+ * @brief	Read a descriptor to its end into the buffer.
+ *
+ * @param	fd The descriptor to read.
+ * @throws	std::runtime_error on a read error.
+ */
+void	InputFile::readAll(int fd)
+{
+	size_t	used = 0;
+
+	_buffer.resize(1 << 16);
+	while (true)
+	{
+		if (used == _buffer.size())
+			_buffer.resize(_buffer.size() * 2);
+		ssize_t	got = read(fd, &_buffer[used], _buffer.size() - used);
+		if (got == 0)
+			break ;
+		if (got < 0)
+		{
+			if (errno == EINTR)
+				continue ;
+			throw std::runtime_error(std::string("Cannot read input : ") + std::strerror(errno));
+		}
+		used += got;
+	}
+	_data = &_buffer[0];
+	_size = used;
+}
+
+/**
+ * @brief	First byte of the input.
+ */
+const char	*InputFile::begin() const
+{
+	return (_data);
+}
+
+/**
+ * @brief	Past-the-end byte of the input.
+ */
+const char	*InputFile::end() const
+{
+	return (_data + _size);
+}
+
+/**
+ * @brief	Size of the input in bytes.
+ */
+size_t	InputFile::size() const
+{
+	return (_size);
+}
+
+/**
+ * @brief	Open an input for reading by chunks.
+ *
+ * @param	path The path of the file, or "-" for standard input.
+ * @throws	std::runtime_error if the input cannot be opened.
+ */
+InputChunks::InputChunks(const std::string &path) : _fd(-1), _buffer(INPUT_CHUNK_SIZE),
+	_start(0), _end(0), _eof(false)
+{
+	_fd = (path == "-") ? STDIN_FILENO : open(path.c_str(), O_RDONLY);
+	if (_fd < 0)
+		throw std::runtime_error("Cannot open " + path + " : " + std::strerror(errno));
+#if defined(POSIX_FADV_SEQUENTIAL)
+	posix_fadvise(_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+}
+
+/**
+ * @brief	Destructor for InputChunks, closing the file if it opened one.
+ */
+InputChunks::~InputChunks()
+{
+	if (_fd != STDIN_FILENO)
+		close(_fd);
+}
+
+/**
+ * @brief	Move the bytes not consumed yet to the front of the buffer and
+ * 			read more after them, until the buffer is full or the input
+ * 			ends. A buffer already full of unconsumed bytes is doubled.
+ *
+ * @return	false once the input is exhausted and every byte consumed.
+ * @throws	std::runtime_error on a read error.
+ */
+bool	InputChunks::fill()
+{
+	if (_start > 0)
+	{
+		std::memmove(&_buffer[0], &_buffer[_start], _end - _start);
+		_end -= _start;
+		_start = 0;
+	}
+	if (_end == _buffer.size())
+		_buffer.resize(_buffer.size() * 2);
+	while (!_eof && _end < _buffer.size())
+	{
+		ssize_t	got = read(_fd, &_buffer[_end], _buffer.size() - _end);
+		if (got == 0)
+			_eof = true;
+		else if (got < 0)
+		{
+			if (errno == EINTR)
+				continue ;
+			throw std::runtime_error(std::string("Cannot read input : ") + std::strerror(errno));
+		}
+		else
+			_end += got;
+	}
+	return (_end > _start);
+}
+
+/**
+ * @brief	First byte not consumed yet.
+ */
+const char	*InputChunks::begin() const
+{
+	return (&_buffer[0] + _start);
+}
+
+/**
+ * @brief	Past-the-end byte of what was read so far.
+ */
+const char	*InputChunks::end() const
+{
+	return (&_buffer[0] + _end);
+}
+
+/**
+ * @brief	End of the whole words read so far: past the last whitespace,
+ * 			since a word running to the end of the buffer may go on in the
+ * 			next read. Everything read once the input ended.
+ */
+const char	*InputChunks::wordsEnd() const
+{
+	size_t	stop = _end;
+
+	if (_eof)
+		return (end());
+	while (stop > _start && !isspace(static_cast<unsigned char>(_buffer[stop - 1])))
+		stop--;
+	return (&_buffer[0] + stop);
+}
+
+/**
+ * @brief	Mark the bytes before p as used.
+ */
+void	InputChunks::consume(const char *p)
+{
+	_start = p - &_buffer[0];
+}
+
+/**
+ * @brief	Whether the end of the input was read.
+ */
+bool	InputChunks::eof() const
+{
+	return (_eof);
+}
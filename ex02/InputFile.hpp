@@ -0,0 +1,85 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   InputFile.hpp                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: benpicar <benpicar@student.42mulhouse.fr>  +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 14:40:27 by benpicar          #+#    #+#             */
+/*   Updated: 2026/10/19 14:40:27 by benpicar         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma once
+
+#ifndef INPUTFILE_HPP
+# define INPUTFILE_HPP
+
+# include <cstddef>
+# include <string>
+# include <vector>
+
+/* Bytes read at a time by InputChunks */
+# define INPUT_CHUNK_SIZE (1 << 20)
+
+/**
+ * @brief	Read-only view of a whole input file, or of standard input when
+ * 			the path is "-".
+ * 			Regular files are mapped in memory, so their bytes are parsed in
+ * 			place; pipes and terminals are read into a buffer grown by
+ * 			doubling. The view stays valid as long as the object lives.
+ */
+class InputFile
+{
+	private:
+		const char			*_data;
+		size_t				_size;
+		void				*_mapping;
+		std::vector<char>	_buffer;
+
+		void	readAll(int fd);
+
+		InputFile(const InputFile &origin);
+		InputFile	&operator=(const InputFile &other);
+
+	public:
+		InputFile(const std::string &path);
+		~InputFile();
+
+		const char	*begin() const;
+		const char	*end() const;
+		size_t		size() const;
+};
+
+/**
+ * @brief	Forward-only reader of an input file, or of standard input when
+ * 			the path is "-", for inputs that must not be held in memory at
+ * 			once. The bytes not consumed yet are kept in a buffer of
+ * 			INPUT_CHUNK_SIZE bytes, refilled with read(2); it only grows for
+ * 			a single word longer than that.
+ */
+class InputChunks
+{
+	private:
+		int					_fd;
+		std::vector<char>	_buffer;
+		size_t				_start;
+		size_t				_end;
+		bool				_eof;
+
+		InputChunks(const InputChunks &origin);
+		InputChunks	&operator=(const InputChunks &other);
+
+	public:
+		InputChunks(const std::string &path);
+		~InputChunks();
+
+		bool		fill();
+		const char	*begin() const;
+		const char	*end() const;
+		const char	*wordsEnd() const;
+		void		consume(const char *p);
+		bool		eof() const;
+};
+
+#endif
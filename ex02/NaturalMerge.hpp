@@ -0,0 +1,496 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   NaturalMerge.hpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: benpicar <benpicar@student.42mulhouse.fr>  +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 16:05:37 by benpicar          #+#    #+#             */
+/*   Updated: 2026/10/19 16:05:37 by benpicar         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma once
+
+#ifndef NATURALMERGE_HPP
+# define NATURALMERGE_HPP
+
+# include <cstddef>
+# include <vector>
+# include <list>
+# include <algorithm>
+
+/* Shortest average run for which merging runs beats merge-insertion */
+# define ADAPTIVE_MIN_RUN 8
+
+/* Runs allowed on top of that average, so a few early disorders pass */
+# define ADAPTIVE_SLACK 8
+
+/* Consecutive wins of one run after which a merge starts galloping */
+# define MIN_GALLOP 7
+
+/**
+ * @brief	Strict weak ordering on values counting every comparison made.
+ *
+ * @tparam	T The type of the values.
+ */
+template <typename T>
+struct ValueLess
+{
+	unsigned long	*count;
+
+	ValueLess(unsigned long *count) : count(count)
+	{}
+
+	bool	operator()(const T &a, const T &b) const
+	{
+		++*count;
+		return (a < b);
+	}
+};
+
+/**
+ * @brief	Tells whether the scan of runs should give up early: past a
+ * 			slack of ADAPTIVE_SLACK runs, runs must average ADAPTIVE_MIN_RUN
+ * 			values. Random input fails this after a few dozen values, so the
+ * 			scan costs little when merge-insertion ends up sorting.
+ */
+inline bool	tooManyRuns(size_t runs, size_t scanned)
+{
+	return (runs > ADAPTIVE_SLACK + scanned / ADAPTIVE_MIN_RUN);
+}
+
+/**
+ * @brief	Tells whether merging runs is sure to beat merge-insertion. The
+ * 			merge is charged the scan, plus n comparisons per level of a
+ * 			balanced merge tree and one more level for galloping; that must
+ * 			stay below n floor(log2 n) - 1.5n, which is less than log2(n!)
+ * 			and so less than what merge-insertion needs.
+ *
+ * @param	n The number of values.
+ * @param	runs The number of runs found.
+ */
+inline bool	runsPayOff(size_t n, size_t runs)
+{
+	size_t	levels = 0;
+	size_t	depth = 0;
+
+	if (runs <= 1)
+		return (true);
+	while ((static_cast<size_t>(1) << levels) < runs)
+		levels++;
+	while ((n >> (depth + 1)) != 0)
+		depth++;
+	return ((n - 1) + n * (levels + 1) + n + n / 2 <= n * depth);
+}
+
+/**
+ * @brief	Most runs findRuns may record before giving up, plus one. Sizes
+ * 			each of the three parts of the arena sortRuns works in.
+ */
+inline size_t	runCapacity(size_t n)
+{
+	return (ADAPTIVE_SLACK + n / ADAPTIVE_MIN_RUN + 2);
+}
+
+/**
+ * @brief	Number of size_t sortRuns needs in its arena: the run
+ * 			boundaries, then the bases and lengths of the run stack.
+ */
+inline size_t	runArenaSize(size_t n)
+{
+	return (3 * runCapacity(n));
+}
+
+/**
+ * @brief	Cuts values into maximal non-descending or strictly descending
+ * 			runs in one scan, reversing the descending ones in place (which
+ * 			keeps equal values in order).
+ *
+ * @param	values The values to scan.
+ * @param	n The number of values.
+ * @param	starts Receives the first index of each run, then n; room for
+ * 			runCapacity(n) elements.
+ * @param	runs Receives the number of runs.
+ * @param	less The comparison.
+ * @return	false if the scan gave up because runs are too short, in which
+ * 			case the values are still a permutation of the input.
+ */
+template <typename T, typename Less>
+bool	findRuns(T *values, size_t n, size_t *starts, size_t &runs, Less &less)
+{
+	size_t	i = 0;
+
+	runs = 0;
+	while (i < n)
+	{
+		starts[runs++] = i;
+		if (tooManyRuns(runs, i))
+			return (false);
+
+		size_t	j = i + 1;
+		if (j < n && less(values[j], values[i]))
+		{
+			while (j + 1 < n && less(values[j + 1], values[j]))
+				++j;
+			std::reverse(values + i, values + j + 1);
+			++j;
+		}
+		else if (j < n)
+		{
+			while (j + 1 < n && !less(values[j + 1], values[j]))
+				++j;
+			++j;
+		}
+		i = j;
+	}
+	starts[runs] = n;
+	return (true);
+}
+
+/**
+ * @brief	Exponential then binary search for the first value of a that
+ * 			key is less than: probes a[0], a[1], a[3], a[7]... so finding
+ * 			position k costs about 2 log2(k) comparisons.
+ */
+template <typename T, typename Less>
+size_t	gallopRight(const T &key, const T *a, size_t n, Less &less)
+{
+	size_t	bound = 1;
+
+	while (bound <= n && !less(key, a[bound - 1]))
+		bound *= 2;
+
+	size_t	lo = bound / 2;
+	size_t	hi = (bound <= n) ? bound - 1 : n;
+
+	while (lo < hi)
+	{
+		size_t	mid = lo + (hi - lo) / 2;
+		if (less(key, a[mid]))
+			hi = mid;
+		else
+			lo = mid + 1;
+	}
+	return (lo);
+}
+
+/**
+ * @brief	Same as gallopRight for the first value of a not less than key.
+ */
+template <typename T, typename Less>
+size_t	gallopLeft(const T &key, const T *a, size_t n, Less &less)
+{
+	size_t	bound = 1;
+
+	while (bound <= n && less(a[bound - 1], key))
+		bound *= 2;
+
+	size_t	lo = bound / 2;
+	size_t	hi = (bound <= n) ? bound - 1 : n;
+
+	while (lo < hi)
+	{
+		size_t	mid = lo + (hi - lo) / 2;
+		if (less(a[mid], key))
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return (lo);
+}
+
+/**
+ * @brief	Merges adjacent runs a and b when a is the shorter: a goes to
+ * 			the buffer and the merge fills the array from the front. After
+ * 			MIN_GALLOP wins in a row, the winning run is searched for the
+ * 			whole stretch it wins at once.
+ */
+template <typename T, typename Less>
+void	mergeLow(T *a, size_t na, T *b, size_t nb, T *buffer, Less &less)
+{
+	T		*left = buffer;
+	T		*leftEnd = std::copy(a, a + na, buffer);
+	T		*right = b;
+	T		*rightEnd = b + nb;
+	T		*dest = a;
+	size_t	winsLeft = 0, winsRight = 0;
+
+	while (left < leftEnd && right < rightEnd)
+	{
+		if (less(*right, *left))
+		{
+			*dest++ = *right++;
+			winsRight++;
+			winsLeft = 0;
+		}
+		else
+		{
+			*dest++ = *left++;
+			winsLeft++;
+			winsRight = 0;
+		}
+		if (winsLeft >= MIN_GALLOP && right < rightEnd)
+		{
+			size_t	k = gallopRight(*right, left, leftEnd - left, less);
+			dest = std::copy(left, left + k, dest);
+			left += k;
+			winsLeft = 0;
+		}
+		else if (winsRight >= MIN_GALLOP && left < leftEnd)
+		{
+			size_t	k = gallopLeft(*left, right, rightEnd - right, less);
+			dest = std::copy(right, right + k, dest);
+			right += k;
+			winsRight = 0;
+		}
+	}
+	std::copy(left, leftEnd, dest);
+}
+
+/**
+ * @brief	Merges adjacent runs a and b when b is the shorter: b goes to
+ * 			the buffer and the merge fills the array from the back, with the
+ * 			same galloping as mergeLow.
+ */
+template <typename T, typename Less>
+void	mergeHigh(T *a, size_t na, T *b, size_t nb, T *buffer, Less &less)
+{
+	T		*leftBegin = a;
+	T		*left = a + na;
+	T		*rightBegin = buffer;
+	T		*right = std::copy(b, b + nb, buffer);
+	T		*dest = b + nb;
+	size_t	winsLeft = 0, winsRight = 0;
+
+	while (left > leftBegin && right > rightBegin)
+	{
+		if (less(right[-1], left[-1]))
+		{
+			*--dest = *--left;
+			winsLeft++;
+			winsRight = 0;
+		}
+		else
+		{
+			*--dest = *--right;
+			winsRight++;
+			winsLeft = 0;
+		}
+		if (winsLeft >= MIN_GALLOP && right > rightBegin)
+		{
+			size_t	k = (left - leftBegin) - gallopRight(right[-1], leftBegin, left - leftBegin, less);
+			dest = std::copy_backward(left - k, left, dest);
+			left -= k;
+			winsLeft = 0;
+		}
+		else if (winsRight >= MIN_GALLOP && left > leftBegin)
+		{
+			size_t	k = (right - rightBegin) - gallopLeft(left[-1], rightBegin, right - rightBegin, less);
+			dest = std::copy_backward(right - k, right, dest);
+			right -= k;
+			winsRight = 0;
+		}
+	}
+	std::copy_backward(rightBegin, right, dest);
+}
+
+/**
+ * @brief	Merges two adjacent runs. The values of a already below b[0]
+ * 			and those of b already above the last of a are found by
+ * 			galloping and left in place, so a misplaced value costs a few
+ * 			comparisons instead of a pass over both runs.
+ */
+template <typename T, typename Less>
+void	mergeAdjacent(T *a, size_t na, size_t nb, T *buffer, Less &less)
+{
+	T		*b = a + na;
+	size_t	skip = gallopRight(b[0], a, na, less);
+
+	a += skip;
+	na -= skip;
+	if (na == 0)
+		return ;
+	nb = gallopLeft(a[na - 1], b, nb, less);
+	if (nb == 0)
+		return ;
+	if (na <= nb)
+		mergeLow(a, na, b, nb, buffer, less);
+	else
+		mergeHigh(a, na, b, nb, buffer, less);
+}
+
+/**
+ * @brief	Merges the runs at depth i and i + 1 of the run stack, which
+ * 			holds depth runs.
+ */
+template <typename T, typename Less>
+void	mergeAt(T *values, size_t *base, size_t *length, size_t &depth, size_t i,
+	T *buffer, Less &less)
+{
+	mergeAdjacent(values + base[i], length[i], length[i + 1], buffer, less);
+	length[i] += length[i + 1];
+	for (size_t k = i + 1; k + 1 < depth; ++k)
+	{
+		base[k] = base[k + 1];
+		length[k] = length[k + 1];
+	}
+	--depth;
+}
+
+/**
+ * @brief	Merges the runs found by findRuns, TimSort style: runs are
+ * 			pushed on a stack whose lengths are kept decreasing at least
+ * 			like Fibonacci numbers, so merges stay balanced and the stack
+ * 			stays logarithmic.
+ *
+ * @param	values The values, sorted on return.
+ * @param	starts The run boundaries given by findRuns.
+ * @param	runs The number of runs.
+ * @param	stack Room for the bases then the lengths of the run stack,
+ * 			runs elements each.
+ * @param	buffer Room for half of the values.
+ * @param	less The comparison.
+ */
+template <typename T, typename Less>
+void	mergeNaturalRuns(T *values, const size_t *starts, size_t runs, size_t *stack,
+	T *buffer, Less &less)
+{
+	size_t	*base = stack;
+	size_t	*length = stack + runs;
+	size_t	depth = 0;
+
+	for (size_t r = 0; r < runs; ++r)
+	{
+		base[depth] = starts[r];
+		length[depth] = starts[r + 1] - starts[r];
+		++depth;
+		while (depth > 1)
+		{
+			size_t	n = depth - 2;
+			if ((n > 0 && length[n - 1] <= length[n] + length[n + 1])
+				|| (n > 1 && length[n - 2] <= length[n - 1] + length[n]))
+			{
+				if (length[n - 1] < length[n + 1])
+					--n;
+			}
+			else if (length[n] > length[n + 1])
+				break ;
+			mergeAt(values, base, length, depth, n, buffer, less);
+		}
+	}
+	while (depth > 1)
+	{
+		size_t	n = depth - 2;
+		if (n > 0 && length[n - 1] < length[n + 1])
+			--n;
+		mergeAt(values, base, length, depth, n, buffer, less);
+	}
+}
+
+/**
+ * @brief	Sorts an array made of few runs, ascending or descending. Works
+ * 			in memory given by the caller, so it never allocates.
+ *
+ * @param	values The values to sort.
+ * @param	n The number of values.
+ * @param	arena Room for runArenaSize(n) elements.
+ * @param	buffer Room for n / 2 + 1 values.
+ * @param	comparisons Incremented by the comparisons made.
+ * @return	false, leaving a permutation of the input, when the runs are too
+ * 			many for merging them to pay off (see runsPayOff).
+ */
+template <typename T>
+bool	sortRuns(T *values, size_t n, size_t *arena, T *buffer, unsigned long &comparisons)
+{
+	unsigned long	count = 0;
+	ValueLess<T>	less(&count);
+	size_t			runs;
+
+	if (!findRuns(values, n, arena, runs, less) || !runsPayOff(n, runs))
+		return (false);
+	if (runs > 1)
+		mergeNaturalRuns(values, arena, runs, arena + runCapacity(n), buffer, less);
+	comparisons += count;
+	return (true);
+}
+
+/**
+ * @brief	Sorts a list made of few runs by relinking its nodes: descending
+ * 			runs are reversed by splicing while they are scanned, then runs
+ * 			are cut into lists of their own and merged pairwise with
+ * 			std::list::merge. Lists have no random access, so there is no
+ * 			galloping here.
+ *
+ * @param	container The list to sort.
+ * @param	comparisons Incremented by the comparisons made.
+ * @return	false, leaving a permutation of the input, when the runs are too
+ * 			many for merging them to pay off (see runsPayOff).
+ */
+template <typename T>
+bool	sortRuns(std::list<T> &container, unsigned long &comparisons)
+{
+	typedef typename std::list<T>::iterator	It;
+	unsigned long							count = 0;
+	ValueLess<T>							less(&count);
+	std::vector<It>							starts;
+	size_t									scanned = 0;
+	It										i = container.begin();
+
+	while (i != container.end())
+	{
+		It	first = i;
+		It	j = i;
+
+		if (tooManyRuns(starts.size() + 1, scanned))
+			return (false);
+		++j;
+		++scanned;
+		if (j != container.end() && less(*j, *i))
+		{
+			do
+			{
+				It	next = j;
+				++next;
+				container.splice(first, container, j);
+				first = j;
+				j = next;
+				++scanned;
+			} while (j != container.end() && less(*j, *first));
+		}
+		else if (j != container.end())
+		{
+			It	prev;
+			do
+			{
+				prev = j;
+				++j;
+				++scanned;
+			} while (j != container.end() && !less(*j, *prev));
+		}
+		starts.push_back(first);
+		i = j;
+	}
+	if (!runsPayOff(scanned, starts.size()))
+		return (false);
+	if (starts.size() > 1)
+	{
+		std::vector<std::list<T> >	runs(starts.size());
+
+		for (size_t r = 0; r < starts.size(); ++r)
+		{
+			It	stop = (r + 1 < starts.size()) ? starts[r + 1] : container.end();
+			runs[r].splice(runs[r].end(), container, starts[r], stop);
+		}
+		for (size_t width = 1; width < runs.size(); width *= 2)
+		{
+			for (size_t r = 0; r + width < runs.size(); r += 2 * width)
+				runs[r].merge(runs[r + width], less);
+		}
+		container.splice(container.end(), runs[0]);
+	}
+	comparisons += count;
+	return (true);
+}
+
+#endif
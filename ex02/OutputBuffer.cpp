@@ -0,0 +1,133 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   OutputBuffer.cpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: benpicar <benpicar@student.42mulhouse.fr>  +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 15:12:40 by benpicar          #+#    #+#             */
+/*   Updated: 2026/10/19 15:12:40 by benpicar         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "OutputBuffer.hpp"
+#include <stdexcept>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+
+/**
+ * @brief	Write a whole block, going on after partial writes and signals.
+ *
+ * @throws	std::runtime_error on a write error.
+ */
+void	writeAll(int fd, const char *data, size_t size)
+{
+	while (size > 0)
+	{
+		ssize_t	done = write(fd, data, size);
+		if (done < 0)
+		{
+			if (errno == EINTR)
+				continue ;
+			throw std::runtime_error(std::string("Cannot write output : ") + std::strerror(errno));
+		}
+		data += done;
+		size -= done;
+	}
+}
+
+/**
+ * @brief	Constructor for OutputBuffer.
+ *
+ * @param	fd The descriptor written to, which stays owned by the caller.
+ * @param	capacity The size of the buffer, at least large enough for one
+ * 			value.
+ */
+OutputBuffer::OutputBuffer(int fd, size_t capacity) : _fd(fd),
+	_data(capacity < 16 ? 16 : capacity), _used(0)
+{}
+
+/**
+ * @brief	Destructor for OutputBuffer. Pending bytes must have been
+ * 			flushed: errors cannot be reported from here.
+ */
+OutputBuffer::~OutputBuffer()
+{}
+
+/**
+ * @brief	Append a value as decimal text followed by a separator. Digits
+ * 			are produced two at a time from a table of the 100 pairs, which
+ * 			halves the divisions.
+ */
+void	OutputBuffer::putValue(unsigned int value, char separator)
+{
+	static const char	pairs[] =
+		"00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+		"40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+		"8081828384858687888990919293949596979899";
+	char				digits[10];
+	char				*start = digits + sizeof(digits);
+
+	if (_data.size() - _used < sizeof(digits) + 1)
+		flush();
+	while (value >= 100)
+	{
+		const char	*pair = pairs + (value % 100) * 2;
+		value /= 100;
+		*--start = pair[1];
+		*--start = pair[0];
+	}
+	if (value >= 10)
+	{
+		*--start = pairs[value * 2 + 1];
+		*--start = pairs[value * 2];
+	}
+	else
+		*--start = static_cast<char>('0' + value);
+
+	size_t	length = digits + sizeof(digits) - start;
+	std::memcpy(&_data[_used], start, length);
+	_used += length;
+	_data[_used++] = separator;
+}
+
+/**
+ * @brief	Append raw bytes.
+ */
+void	OutputBuffer::putRaw(const void *data, size_t size)
+{
+	const char	*bytes = static_cast<const char *>(data);
+
+	if (_data.size() - _used < size)
+	{
+		flush();
+		if (size >= _data.size())
+		{
+			writeAll(_fd, bytes, size);
+			return ;
+		}
+	}
+	std::memcpy(&_data[_used], bytes, size);
+	_used += size;
+}
+
+/**
+ * @brief	Append a string.
+ */
+void	OutputBuffer::putString(const std::string &text)
+{
+	putRaw(text.data(), text.size());
+}
+
+/**
+ * @brief	Write out everything buffered so far.
+ *
+ * @throws	std::runtime_error on a write error.
+ */
+void	OutputBuffer::flush()
+{
+	if (_used > 0)
+		writeAll(_fd, &_data[0], _used);
+	_used = 0;
+}
@@ -0,0 +1,52 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   OutputBuffer.hpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: benpicar <benpicar@student.42mulhouse.fr>  +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 15:12:40 by benpicar          #+#    #+#             */
+/*   Updated: 2026/10/19 15:12:40 by benpicar         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma once
+
+#ifndef OUTPUTBUFFER_HPP
+# define OUTPUTBUFFER_HPP
+
+# include <cstddef>
+# include <string>
+# include <vector>
+
+/* Default size of an OutputBuffer, in bytes */
+# define OUTPUT_BUFFER_SIZE (1 << 20)
+
+/**
+ * @brief	Write buffer on a file descriptor, flushed with write(2) in
+ * 			large blocks. Values are written either as decimal text or as
+ * 			raw bytes.
+ */
+class OutputBuffer
+{
+	private:
+		int					_fd;
+		std::vector<char>	_data;
+		size_t				_used;
+
+		OutputBuffer(const OutputBuffer &origin);
+		OutputBuffer	&operator=(const OutputBuffer &other);
+
+	public:
+		OutputBuffer(int fd, size_t capacity = OUTPUT_BUFFER_SIZE);
+		~OutputBuffer();
+
+		void	putValue(unsigned int value, char separator);
+		void	putRaw(const void *data, size_t size);
+		void	putString(const std::string &text);
+		void	flush();
+};
+
+void	writeAll(int fd, const char *data, size_t size);
+
+#endif
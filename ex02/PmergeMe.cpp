@@ -6,16 +6,26 @@
 /*   By: benpicar <benpicar@student.42mulhouse.fr>  +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/06/23 15:38:49 by benpicar          #+#    #+#             */
-/*   Updated: 2025/06/24 17:21:16 by benpicar         ###   ########.fr       */
+/*   Updated: 2026/10/19 12:41:44 by benpicar         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "PmergeMe.hpp"
+#include "SortPolicies.hpp"
+#include "InputFile.hpp"
+#include "ExternalSort.hpp"
+#include "Profiler.hpp"
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sstream>
+#include <cstring>
 
 /**
  * @brief	Default constructor for PmergeMe.
  */
-PmergeMe::PmergeMe()
+PmergeMe::PmergeMe() : _threads(1), _strategy(MERGE_INSERTION),
+	_echoLimit(static_cast<size_t>(-1)), _sorted(true), _out(STDOUT_FILENO)
 {}
 
 /**
@@ -23,7 +33,9 @@ PmergeMe::PmergeMe()
  * 
  * @param	origin The PmergeMe object to copy from.
  */
-PmergeMe::PmergeMe(const PmergeMe &origin) : _vector(origin._vector), _list(origin._list)
+PmergeMe::PmergeMe(const PmergeMe &origin) : _vector(origin._vector), _list(origin._list),
+	_threads(origin._threads), _strategy(origin._strategy),
+	_echoLimit(origin._echoLimit), _sorted(origin._sorted), _out(STDOUT_FILENO)
 {}
 
 /**
@@ -38,6 +50,10 @@ PmergeMe &PmergeMe::operator=(const PmergeMe &other)
 	{
 		_vector = other._vector;
 		_list = other._list;
+		_threads = other._threads;
+		_strategy = other._strategy;
+		_echoLimit = other._echoLimit;
+		_sorted = other._sorted;
 	}
 	return (*this);
 }
@@ -48,6 +64,39 @@ PmergeMe &PmergeMe::operator=(const PmergeMe &other)
 PmergeMe::~PmergeMe()
 {}
 
+/**
+ * @brief	Set how many threads the sorts may use. Only inputs of at least
+ * 			PARALLEL_MIN_SIZE numbers are actually split. Defaults to 1.
+ * 
+ * @param	threads The maximum number of threads, 0 being treated as 1.
+ */
+void	PmergeMe::setThreads(unsigned int threads)
+{
+	_threads = (threads == 0) ? 1 : threads;
+}
+
+/**
+ * @brief	Select the engine sortContainers uses (see SortPolicies.hpp).
+ * 
+ * @param	strategy MERGE_INSERTION (the default), RADIX, NETWORK, HYBRID,
+ * 			or ALL_STRATEGIES to time every engine on the same input.
+ */
+void	PmergeMe::setStrategy(Strategy strategy)
+{
+	_strategy = strategy;
+}
+
+/**
+ * @brief	Set how many values the Before and After lines show.
+ * 
+ * @param	limit The number of values shown before "[...]", 0 to skip both
+ * 			lines. All values are shown by default.
+ */
+void	PmergeMe::setEchoLimit(size_t limit)
+{
+	_echoLimit = limit;
+}
+
 /**
  * @brief	Get the vector of unsigned integers.
  * 
@@ -69,17 +118,171 @@ std::list<unsigned int> const	&PmergeMe::getList() const
 }
 
 /**
- * @brief	Advances the index past any whitespace characters in the string.
+ * @brief	Monotonic wall clock, in microseconds. Unlike clock(), it counts
+ * 			the time spent waiting and is not summed over threads.
+ */
+static double	wallClock()
+{
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec * 1e6 + ts.tv_nsec / 1e3);
+}
+
+/**
+ * @brief	Returns the first byte at or after p that is not whitespace.
+ * 
+ * @param	p The current position.
+ * @param	end The end of the text.
+ */
+const char	*PmergeMe::nextInfo(const char *p, const char *end)
+{
+	while (p < end && isspace(static_cast<unsigned char>(*p)))
+	{
+		p++;
+	}
+	return (p);
+}
+
+/**
+ * @brief	Reads 8 ASCII digits at once (SWAR): the bytes are checked and
+ * 			combined by pairs, then quads, with three multiplications
+ * 			instead of eight dependent multiply-adds. Only used on little
+ * 			endian hosts, where byte 0 is the most significant digit.
+ * 
+ * @param	p At least 8 readable bytes.
+ * @param	chunk Receives the value of the digits.
+ * @return	false if any of the 8 bytes is not a digit.
+ */
+static bool	eightDigits(const char *p, unsigned long long &chunk)
+{
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	unsigned long long	v;
+
+	std::memcpy(&v, p, sizeof(v));
+	if ((v & 0xF0F0F0F0F0F0F0F0ULL) != 0x3030303030303030ULL
+		|| ((v + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) != 0x3030303030303030ULL)
+		return (false);
+	v -= 0x3030303030303030ULL;
+	v = (v * 10) + (v >> 8);
+	v = (((v & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32)))
+		+ (((v >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >> 32;
+	chunk = v & 0xFFFFFFFFULL;
+	return (true);
+#else
+	(void)p;
+	(void)chunk;
+	return (false);
+#endif
+}
+
+/**
+ * @brief	Parses the run of digits starting at p, in place. A value past
+ * 			UINT_MAX stops growing, so any number of digits is safe.
+ * 
+ * @param	p The first digit.
+ * @param	end The end of the text.
+ * @param	value Receives the number, greater than UINT_MAX if too large.
+ * @return	The first byte after the digits.
+ */
+static const char	*parseDigits(const char *p, const char *end, unsigned long long &value)
+{
+	unsigned long long	chunk;
+
+	value = 0;
+	while (end - p >= 8 && eightDigits(p, chunk))
+	{
+		if (value <= UINT_MAX)
+			value = value * 100000000ULL + chunk;
+		p += 8;
+	}
+	while (p < end && isdigit(static_cast<unsigned char>(*p)))
+	{
+		if (value <= UINT_MAX)
+			value = value * 10 + (*p - '0');
+		p++;
+	}
+	return (p);
+}
+
+/**
+ * @brief	Counts the runs of digits of a text, an upper bound of the
+ * 			number of values it holds, used to reserve the vector.
+ */
+static size_t	countNumbers(const char *p, const char *end)
+{
+	size_t	count = 0;
+	bool	inside = false;
+
+	for (; p < end; ++p)
+	{
+		bool	digit = static_cast<unsigned char>(*p - '0') < 10;
+		count += (digit && !inside);
+		inside = digit;
+	}
+	return (count);
+}
+
+/**
+ * @brief	Parses whitespace-separated numbers, each with an optional '+',
+ * 			and appends them to a vector. The text is read in place.
  * 
- * @param	str The string to process.
- * @param	index The current index in the string.
+ * @param	values The vector receiving the numbers.
+ * @param	begin The first byte of the text.
+ * @param	end The end of the text.
+ * @param	context The text quoted in error messages, or NULL to quote the
+ * 			whitespace-separated word holding the error.
+ * @param	limit Parsing stops at the first word starting after this many
+ * 			values were appended.
+ * @return	Where parsing stopped, end once the whole text is read.
+ * @throws	std::invalid_argument if the text contains invalid characters or formats.
+ * @throws	std::out_of_range if a number exceeds the maximum value for unsigned int.
  */
-void	PmergeMe::nextInfo(std::string &str, size_t &index) const
+const char	*PmergeMe::parseText(std::vector<unsigned int> &values, const char *begin,
+	const char *end, const char *context, size_t limit)
 {
-	while (index < str.length() && isspace(str[index]))
+	const char			*p = nextInfo(begin, end);
+	const char			*word = p;
+	size_t				stop = values.size() + std::min(limit, ~size_t(0) - values.size());
+	unsigned long long	num;
+
+	while (p < end && (p != word || values.size() < stop))
 	{
-		index++;
+		if (!isdigit(static_cast<unsigned char>(*p)))
+		{
+			if (*p != '+' || p + 1 >= end || !isdigit(static_cast<unsigned char>(p[1])))
+			{
+				throw std::invalid_argument("Invalid input : " + quote(context, word, end));
+			}
+			p++;
+		}
+		p = parseDigits(p, end, num);
+		if (num > UINT_MAX)
+		{
+			throw std::out_of_range("Number out of range : " + quote(context, word, end));
+		}
+		values.push_back(static_cast<unsigned int>(num));
+
+		const char	*next = nextInfo(p, end);
+		if (next != p)
+			word = next;
+		p = next;
 	}
+	return (p);
+}
+
+/**
+ * @brief	Builds the text quoted by an error message of parseText.
+ */
+std::string PmergeMe::quote(const char *context, const char *word, const char *end)
+{
+	const char	*stop = word;
+
+	if (context != NULL)
+		return (context);
+	while (stop < end && !isspace(static_cast<unsigned char>(*stop)))
+		stop++;
+	return (std::string(word, stop));
 }
 
 /**
@@ -92,71 +295,475 @@ void	PmergeMe::nextInfo(std::string &str, size_t &index) const
  */
 void PmergeMe::fillContainer(char **numbers, int length)
 {
-	std::string	str;
-	size_t		index;
+	ProfileRegion	region("parse arguments");
+	size_t			first = _vector.size();
+	size_t			count = first;
 
 	for (int i = 0; i < length; ++i)
+		count += countNumbers(numbers[i], numbers[i] + std::strlen(numbers[i]));
+	_vector.reserve(count);
+	for (int i = 0; i < length; ++i)
+		parseText(_vector, numbers[i], numbers[i] + std::strlen(numbers[i]), numbers[i], ~size_t(0));
+	_list.insert(_list.end(), _vector.begin() + first, _vector.end());
+	_sorted = _sorted && _vector.size() == first;
+}
+
+/**
+ * @brief	Appends the values of a file, or of standard input when path is
+ * 			"-", to a vector. Text input follows the rules of fillContainer;
+ * 			binary input is a sequence of raw unsigned int values in host
+ * 			byte order.
+ * 
+ * @param	path The file to read.
+ * @param	binary Whether the file holds raw values instead of text.
+ * @param	values The vector receiving the values.
+ * @throws	std::runtime_error if the file cannot be read.
+ * @throws	std::invalid_argument if the input is malformed.
+ * @throws	std::out_of_range if a number exceeds the maximum value for unsigned int.
+ */
+void PmergeMe::readFile(const std::string &path, bool binary, std::vector<unsigned int> &values)
+{
+	ProfileRegion	region("parse file");
+	InputFile		input(path);
+	size_t			first = values.size();
+
+	if (!binary)
 	{
-		str = numbers[i];
-		index = 0;
+		values.reserve(first + countNumbers(input.begin(), input.end()));
+		parseText(values, input.begin(), input.end(), NULL, ~size_t(0));
+	}
+	else
+	{
+		if (input.size() % sizeof(unsigned int) != 0)
+		{
+			throw std::invalid_argument("Invalid input : " + path + " does not hold whole values");
+		}
+		values.resize(first + input.size() / sizeof(unsigned int));
+		if (input.size() > 0)
+			std::memcpy(&values[first], input.begin(), input.size());
+	}
+}
+
+/**
+ * @brief	Fills the containers from a file, or from standard input when
+ * 			path is "-" (see readFile).
+ * 
+ * @param	path The file to read.
+ * @param	binary Whether the file holds raw values instead of text.
+ * @throws	std::runtime_error if the file cannot be read.
+ * @throws	std::invalid_argument if the input is malformed.
+ * @throws	std::out_of_range if a number exceeds the maximum value for unsigned int.
+ */
+void PmergeMe::fillFromFile(const std::string &path, bool binary)
+{
+	size_t	first = _vector.size();
 
-		nextInfo(str, index);
-		while (index < str.length())
+	readFile(path, binary, _vector);
+	_list.insert(_list.end(), _vector.begin() + first, _vector.end());
+	_sorted = _sorted && _vector.size() == first;
+}
+
+/**
+ * @brief	Sorts a file that may not fit in memory. The input is read by
+ * 			chunks (see InputChunks), standard input included, and cut into
+ * 			runs of memory / EXTERNAL_BYTES_PER_VALUE values, each one is
+ * 			sorted in the vector with the selected strategy and spilled to a
+ * 			temporary file, then the runs are merged into the output. The
+ * 			list is not used, and nothing but the report is printed.
+ * 
+ * @param	path The file to sort, "-" for standard input.
+ * @param	binary Whether input and output hold raw values instead of text.
+ * @param	output The file receiving the sorted values, "-" for standard
+ * 			output; text output has one value per line.
+ * @param	memory The number of bytes a run and its sort may use.
+ * @throws	std::runtime_error on an I/O error.
+ * @throws	std::invalid_argument if the input is malformed.
+ * @throws	std::out_of_range if a number exceeds the maximum value for unsigned int.
+ */
+void PmergeMe::sortExternal(const std::string &path, bool binary, const std::string &output,
+	size_t memory)
+{
+	ProfileRegion	region("external sort");
+	InputChunks		input(path);
+	ExternalSort	runs(memory);
+	size_t			runLength = std::max<size_t>(memory / EXTERNAL_BYTES_PER_VALUE, 1);
+	double			start = wallClock();
+
+	_vector.clear();
+	_list.clear();
+	_vector.reserve(runLength);
+	while (true)
+	{
+		_vector.clear();
+		while (_vector.size() < runLength)
 		{
-			if (!isdigit(str[index]))
+			const char	*stop = input.wordsEnd();
+			if (binary)
+				stop = input.begin() + (input.end() - input.begin())
+					/ sizeof(unsigned int) * sizeof(unsigned int);
+			if (stop == input.begin())
 			{
-				if (str[index] != '+' || !isdigit(str[index + 1]))
+				if (!input.eof())
 				{
-					throw std::invalid_argument("Invalid input : " + str);
+					input.fill();
+					continue ;
 				}
-				index++;
-			}
-			unsigned long num = std::strtoul(str.substr(index).c_str(), NULL, 10);
-			if (num > UINT_MAX)
-			{
-				throw std::out_of_range("Number out of range : " + str);
+				if (input.begin() != input.end())
+				{
+					throw std::invalid_argument("Invalid input : " + path
+						+ " does not hold whole values");
+				}
+				break ;
 			}
-			_vector.push_back(static_cast<unsigned int>(num));
-			_list.push_back(static_cast<unsigned int>(num));
-
-			while (index < str.length() && isdigit(str[index]))
+			if (binary)
 			{
-				index++;
+				size_t	first = _vector.size();
+				size_t	count = std::min<size_t>((stop - input.begin()) / sizeof(unsigned int),
+					runLength - first);
+				_vector.resize(first + count);
+				std::memcpy(&_vector[first], input.begin(), count * sizeof(unsigned int));
+				input.consume(input.begin() + count * sizeof(unsigned int));
 			}
-			nextInfo(str, index);
+			else
+				input.consume(parseText(_vector, input.begin(), stop, NULL,
+					runLength - _vector.size()));
 		}
+		if (_vector.empty())
+			break ;
+		sortRun();
+		runs.addRun(&_vector[0], _vector.size());
+	}
+	std::vector<unsigned int>().swap(_vector);
+	_sorted = true;
+
+	int	fd = (output == "-") ? STDOUT_FILENO
+		: open(output.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0)
+		throw std::runtime_error("Cannot open " + output + " : " + std::strerror(errno));
+	size_t	count = runs.runCount();
+	try
+	{
+		runs.merge(fd, !binary);
+	}
+	catch (...)
+	{
+		if (fd != STDOUT_FILENO)
+			close(fd);
+		throw ;
+	}
+	if (fd != STDOUT_FILENO)
+		close(fd);
+
+	double	time = wallClock() - start;
+	std::ostream	&report = (output == "-") ? std::cerr : std::cout;
+	report << GREEN << "Time to process a range of " << runs.size()
+		   << " elements with an external merge of " << count << " runs : "
+		   << time << " microseconds" << NC << std::endl;
+}
+
+/**
+ * @brief	Sorts the vector alone with the selected strategy, as one run of
+ * 			the external sort. ALL_STRATEGIES uses merge-insertion.
+ */
+void PmergeMe::sortRun()
+{
+	switch (_strategy)
+	{
+		case RADIX:
+			RadixSort::sort(_vector, _threads);
+			break ;
+		case NETWORK:
+			NetworkSort::sort(_vector, _threads);
+			break ;
+		case HYBRID:
+			HybridSort::sort(_vector, _threads);
+			break ;
+		default:
+			MergeInsertionSort::sort(_vector, _threads);
 	}
 }
 
 /**
  * @brief	Sorts the vector and list containers.
- * 			This function uses a merge-insertion sort algorithm to sort the elements
- * 			in both containers.
+ * 			Both are sorted with the selected strategy, merge-insertion by
+ * 			default.
  */
 void PmergeMe::sortContainers()
 {
-	clock_t	start, end;
-	
-	std::cout << "Before: ";
-	printContainers(_vector);
-	start = clock();
-	sortCo(_vector);
-	end = clock();
-	std::cout << "After: ";
-	printContainers(_vector);
-	double time = static_cast<double>(end - start) / CLOCKS_PER_SEC * 1000000.0;
-	std::cout << GREEN << "Time to process a range of " << _vector.size()
-			  << " elements with std::vector : " << time << " microseconds" << NC << std::endl;
-	
-	std::cout << "Before: ";
-	printContainers(_list);
-	start = clock();
-	sortCo(_list);
-	end = clock();
-	std::cout << "After: ";
-	printContainers(_list);
-	time = static_cast<double>(end - start) / CLOCKS_PER_SEC * 1000000.0;
-	std::cout << GREEN << "Time to process a range of " << _list.size()
-			  << " elements with std::list : " << time << " microseconds" << NC << std::endl; 
+	sortContainer(_vector, "std::vector");
+	sortContainer(_list, "std::list");
+	_sorted = true;
+}
+
+/**
+ * @brief	Sorts one container and reports it: before and after contents,
+ * 			then the time and comparisons of each strategy run. With
+ * 			ALL_STRATEGIES, every other engine is first timed on its own
+ * 			copy of the input, and merge-insertion sorts the container.
+ * 
+ * @param	container The container to sort.
+ * @param	type The container name used in the report.
+ * @tparam	Co The type of the container.
+ */
+template <typename Co>
+void PmergeMe::sortContainer(Co &container, const char *type) const
+{
+	std::ostringstream	report;
+
+	printContainers(_out, "Before: ", container, _echoLimit);
+	switch (_strategy)
+	{
+		case RADIX:
+			timeSort<RadixSort>(container, type, report);
+			break ;
+		case NETWORK:
+			timeSort<NetworkSort>(container, type, report);
+			break ;
+		case HYBRID:
+			timeSort<HybridSort>(container, type, report);
+			break ;
+		case ALL_STRATEGIES:
+		{
+			Co	copy(container);
+			timeSort<RadixSort>(copy, type, report);
+			copy = container;
+			timeSort<NetworkSort>(copy, type, report);
+			copy = container;
+			timeSort<HybridSort>(copy, type, report);
+		}
+		// fall through
+		default:
+			timeSort<MergeInsertionSort>(container, type, report);
+	}
+	printContainers(_out, "After: ", container, _echoLimit);
+	std::cout << report.str();
+}
+
+/**
+ * @brief	Sorts a container with one policy and writes its time and
+ * 			comparison count. The strategy name follows the container name
+ * 			unless merge-insertion is the only strategy run.
+ * 
+ * @param	container The container to sort.
+ * @param	type The container name used in the report.
+ * @param	report The stream receiving the report lines.
+ * @tparam	Policy The sort policy to run.
+ * @tparam	Co The type of the container.
+ */
+template <typename Policy, typename Co>
+void PmergeMe::timeSort(Co &container, const char *type, std::ostream &report) const
+{
+	double			start, end;
+	unsigned long	comparisons;
+
+	std::string		name = std::string(Policy::name()) + " " + type;
+
+	start = wallClock();
+	{
+		ProfileRegion	region(name.c_str());
+		comparisons = Policy::sort(container, _threads);
+	}
+	end = wallClock();
+	double time = end - start;
+	report << GREEN << "Time to process a range of " << container.size()
+		   << " elements with " << type;
+	if (_strategy != MERGE_INSERTION)
+		report << " (" << Policy::name() << ")";
+	report << " : " << time << " microseconds" << NC << std::endl;
+	printComparisons(report, comparisons, container.size(),
+		Policy::runs(container.size(), _threads));
+}
+
+/**
+ * @brief	Adds a batch of values to containers kept sorted, instead of
+ * 			sorting the whole history again: the batch is sorted on its own
+ * 			with merge-insertion, then merged into each container (see
+ * 			mergeSorted). The report shows the batch, each container after
+ * 			the merge, and the time and comparisons of both, next to the
+ * 			Ford-Johnson worst case of sorting everything again.
+ * 
+ * @param	batch The new values, in any order.
+ * @throws	std::logic_error if the containers were filled since they were
+ * 			last sorted.
+ */
+void PmergeMe::mergeBatch(const std::vector<unsigned int> &batch)
+{
+	if (!_sorted)
+	{
+		throw std::logic_error("Containers must be sorted before a batch is merged");
+	}
+	printContainers(_out, "Batch: ", batch, _echoLimit);
+	mergeInto(_vector, batch, "std::vector");
+	mergeInto(_list, batch, "std::list");
+}
+
+/**
+ * @brief	Merges a batch read from a file, or from standard input when
+ * 			path is "-" (see readFile). The batch is parsed straight into a
+ * 			vector, with no container or output buffer of its own.
+ * 
+ * @param	path The file to read.
+ * @param	binary Whether the file holds raw values instead of text.
+ * @throws	std::runtime_error if the file cannot be read.
+ * @throws	std::invalid_argument if the input is malformed.
+ * @throws	std::out_of_range if a number exceeds the maximum value for unsigned int.
+ * @throws	std::logic_error if the containers are not sorted.
+ */
+void PmergeMe::mergeFromFile(const std::string &path, bool binary)
+{
+	std::vector<unsigned int>	batch;
+
+	readFile(path, binary, batch);
+	mergeBatch(batch);
+}
+
+/**
+ * @brief	Sorts a batch in a container of its own and merges it into one
+ * 			of the containers, then reports it.
+ * 
+ * @param	container The sorted container receiving the batch.
+ * @param	batch The new values.
+ * @param	type The container name used in the report.
+ * @tparam	Co The type of the container.
+ */
+template <typename Co>
+void PmergeMe::mergeInto(Co &container, const std::vector<unsigned int> &batch, const char *type)
+{
+	double			start, end;
+	unsigned long	comparisons;
+	size_t			n = container.size();
+
+	std::string		name = std::string("merge batch ") + type;
+
+	start = wallClock();
+	{
+		ProfileRegion	region(name.c_str());
+		Co				sorted(batch.begin(), batch.end());
+		comparisons = sortCo(sorted, _threads);
+		comparisons += mergeSorted(container, sorted);
+	}
+	end = wallClock();
+	double time = end - start;
+	printContainers(_out, "After: ", container, _echoLimit);
+	std::cout << GREEN << "Time to merge a batch of " << batch.size() << " elements into "
+			  << n << " elements with " << type << " : " << time << " microseconds" << NC
+			  << std::endl;
+	printComparisons(std::cout, comparisons, container.size(),
+		parallelRuns(batch.size(), _threads));
+}
+
+/**
+ * @brief	The k largest values, largest first. Sorted containers are
+ * 			read from their end; otherwise the values are selected in one
+ * 			pass that never sorts more than k of them (see selectFirst).
+ * 
+ * @param	k The number of values wanted.
+ * @param	comparisons Incremented by the comparisons made.
+ * @return	At most k values.
+ */
+std::vector<unsigned int> PmergeMe::topK(size_t k, unsigned long &comparisons) const
+{
+	std::vector<unsigned int>	top;
+
+	k = std::min(k, _vector.size());
+	if (_sorted)
+		return (std::vector<unsigned int>(_vector.rbegin(), _vector.rbegin() + k));
+	top = selectFirst(_vector.begin(), _vector.end(), k,
+		ValueGreater<unsigned int>(&comparisons), comparisons);
+	std::reverse(top.begin(), top.end());
+	return (top);
+}
+
+/**
+ * @brief	The k smallest values, in ascending order: what the first k
+ * 			values of a full sort would be, without sorting the others.
+ * 
+ * @param	k The number of values wanted.
+ * @param	comparisons Incremented by the comparisons made.
+ * @return	At most k values.
+ */
+std::vector<unsigned int> PmergeMe::partialSort(size_t k, unsigned long &comparisons) const
+{
+	k = std::min(k, _vector.size());
+	if (_sorted)
+		return (std::vector<unsigned int>(_vector.begin(), _vector.begin() + k));
+	return (selectFirst(_vector.begin(), _vector.end(), k,
+		ValueLess<unsigned int>(&comparisons), comparisons));
+}
+
+/**
+ * @brief	Runs topK or partialSort and prints the values found with the
+ * 			time and comparisons it took.
+ * 
+ * @param	k The number of values wanted.
+ * @param	top Whether the largest values are wanted instead of the
+ * 			smallest ones.
+ */
+void PmergeMe::printQuery(size_t k, bool top) const
+{
+	double						start, end;
+	unsigned long				comparisons = 0;
+	std::vector<unsigned int>	values;
+
+	start = wallClock();
+	{
+		ProfileRegion	region(top ? "top-k" : "partial sort");
+		values = top ? topK(k, comparisons) : partialSort(k, comparisons);
+	}
+	end = wallClock();
+	double time = end - start;
+	printContainers(_out, top ? "Top: " : "First: ", values, _echoLimit);
+	std::cout << GREEN << "Time to select the " << (top ? "largest " : "smallest ")
+			  << values.size() << " of " << _vector.size() << " elements : " << time
+			  << " microseconds" << NC << std::endl
+			  << "Comparisons: " << comparisons << std::endl;
+}
+
+/**
+ * @brief	Writes the number of comparisons made by a sort next to the
+ * 			Ford-Johnson worst case for the same size. A sort split into
+ * 			runs merged afterwards is not one Ford-Johnson sort, which the
+ * 			line then says.
+ * 
+ * @param	out The stream to write to.
+ * @param	comparisons The number of comparisons made.
+ * @param	n The number of elements sorted.
+ * @param	runs The number of runs the sort was split into.
+ */
+void PmergeMe::printComparisons(std::ostream &out, unsigned long comparisons, size_t n,
+	size_t runs) const
+{
+	out << "Comparisons: " << comparisons << " (Ford-Johnson worst case: "
+		<< fordJohnsonBound(n);
+	if (runs > 1)
+		out << "; " << runs << " runs sorted on their own threads then merged, which adds"
+			<< " comparisons";
+	out << ")" << std::endl;
+}
+
+/**
+ * @brief	Worst-case number of comparisons of the Ford-Johnson algorithm,
+ * 			F(n) = sum for k = 1..n of ceil(log2(3k / 4)).
+ * 
+ * @param	n The number of elements.
+ * @return	The maximum number of comparisons to sort n elements.
+ */
+unsigned long PmergeMe::fordJohnsonBound(size_t n)
+{
+	unsigned long	total = 0;
+	unsigned long	power = 1;
+	unsigned long	exponent = 0;
+
+	for (size_t k = 1; k <= n; ++k)
+	{
+		// Smallest exponent with 4 * 2^exponent >= 3k
+		while (4 * power < 3 * k)
+		{
+			power *= 2;
+			exponent++;
+		}
+		total += exponent;
+	}
+	return (total);
 }
 
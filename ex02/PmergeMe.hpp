@@ -6,7 +6,7 @@
 /*   By: benpicar <benpicar@student.42mulhouse.fr>  +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/06/20 16:21:57 by benpicar          #+#    #+#             */
-/*   Updated: 2025/06/24 17:30:54 by benpicar         ###   ########.fr       */
+/*   Updated: 2026/10/19 12:43:58 by benpicar         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -16,15 +16,30 @@
 # define PMERGEME_HPP
 
 # include <iostream>
+# include <string>
 # include <vector>
 # include <list>
 # include <algorithm>
 # include <stdexcept>
 # include <cctype>
 # include <ctime>
+# include <pthread.h>
+# include "BlockChain.hpp"
+# include "NaturalMerge.hpp"
+# include "OutputBuffer.hpp"
+# include <unistd.h>
 
 # define UINT_MAX 4294967295
 
+/*
+ * Bytes of memory budget per value of an external sort run: the value, the
+ * copy or buffer of the sort engine, and merge-insertion's index arena
+ */
+# define EXTERNAL_BYTES_PER_VALUE 64
+
+/* Smallest input split between several threads */
+# define PARALLEL_MIN_SIZE 32768
+
 # define GREEN	"\033[0;92m"
 # define RED	"\033[0;91m"
 # define BLUE	"\033[0;94m"
@@ -38,11 +53,42 @@
  */
 class PmergeMe
 {
+	public:
+		enum Strategy
+		{
+			MERGE_INSERTION,
+			RADIX,
+			NETWORK,
+			HYBRID,
+			ALL_STRATEGIES
+		};
+
 	private:
 		std::vector<unsigned int>	_vector;
 		std::list<unsigned int>		_list;
+		unsigned int				_threads;
+		Strategy					_strategy;
+		size_t						_echoLimit;
+		bool						_sorted;
+		mutable OutputBuffer		_out;
 
-		void		nextInfo(std::string &str, size_t &index) const;
+		static const char	*nextInfo(const char *p, const char *end);
+		static const char	*parseText(std::vector<unsigned int> &values, const char *begin,
+								const char *end, const char *context, size_t limit);
+		static std::string	quote(const char *context, const char *word, const char *end);
+		static void			readFile(const std::string &path, bool binary,
+								std::vector<unsigned int> &values);
+		void		sortRun();
+		void		printComparisons(std::ostream &out, unsigned long comparisons, size_t n,
+						size_t runs) const;
+
+		template <typename Co>
+		void		sortContainer(Co &container, const char *type) const;
+		template <typename Policy, typename Co>
+		void		timeSort(Co &container, const char *type, std::ostream &report) const;
+		template <typename Co>
+		void		mergeInto(Co &container, const std::vector<unsigned int> &batch,
+						const char *type);
 
 	public:
 		PmergeMe();
@@ -53,8 +99,22 @@ class PmergeMe
 		std::vector<unsigned int> const	&getVector() const;
 		std::list<unsigned int> const	&getList() const;
 
+		void		setThreads(unsigned int threads);
+		void		setStrategy(Strategy strategy);
+		void		setEchoLimit(size_t limit);
 		void		fillContainer(char **numbers, int length);
+		void		fillFromFile(const std::string &path, bool binary);
+		void		sortExternal(const std::string &path, bool binary, const std::string &output,
+						size_t memory);
 		void		sortContainers();
+		void		mergeBatch(const std::vector<unsigned int> &batch);
+		void		mergeFromFile(const std::string &path, bool binary);
+
+		std::vector<unsigned int>	topK(size_t k, unsigned long &comparisons) const;
+		std::vector<unsigned int>	partialSort(size_t k, unsigned long &comparisons) const;
+		void						printQuery(size_t k, bool top) const;
+
+		static unsigned long	fordJohnsonBound(size_t n);
 };
 
 /**
@@ -85,92 +145,697 @@ bool	isSorted(const Co &container)
 	return (true);
 }
 
+/**
+ * @brief	Strict weak ordering on element indices, comparing the values they
+ * 			refer to and counting every comparison made.
+ * 
+ * @tparam	T The type of the values.
+ */
+template <typename T>
+struct CountingLess
+{
+	const T			*values;
+	unsigned long	*count;
+
+	CountingLess(const T *values, unsigned long *count) : values(values), count(count)
+	{}
+
+	bool	operator()(size_t a, size_t b) const
+	{
+		++*count;
+		return (values[a] < values[b]);
+	}
+};
+
+/**
+ * @brief	Strict weak ordering on element indices for node-based
+ * 			containers, comparing through iterators so values are never
+ * 			copied, and counting every comparison made.
+ * 
+ * @tparam	It The iterator type of the container.
+ */
+template <typename It>
+struct IteratorLess
+{
+	const It		*iterators;
+	unsigned long	*count;
+
+	IteratorLess(const It *iterators, unsigned long *count) : iterators(iterators), count(count)
+	{}
+
+	bool	operator()(size_t a, size_t b) const
+	{
+		++*count;
+		return (*iterators[a] < *iterators[b]);
+	}
+};
+
+/**
+ * @brief	Get the k-th Jacobsthal number, (2^k - (-1)^k) / 3.
+ * 			Ford-Johnson inserts the pending elements in groups ending at
+ * 			t_k = J(k + 1): 1, 3, 5, 11, 21, 43...
+ */
+inline size_t	jacobsthal(size_t k)
+{
+	size_t	power = static_cast<size_t>(1) << k;
+
+	return ((k % 2 == 0) ? (power - 1) / 3 : (power + 1) / 3);
+}
+
+/**
+ * @brief	Ford-Johnson merge-insertion on element indices.
+ * 			Elements are paired and compared, the larger ones are sorted
+ * 			recursively, then each smaller one is inserted by binary search.
+ * 			Insertions follow the Jacobsthal order and the search for b_j is
+ * 			bounded by the position of its partner a_j, so every search
+ * 			covers at most 2^k - 1 elements in group k: the number of
+ * 			comparisons stays within the Ford-Johnson worst case.
+ * 
+ * @param	ids The indices to sort, replaced by their sorted order.
+ * @param	partner Scratch table indexed by element, at least as large as the
+ * 			largest index. Each level stores there the smaller partner of its
+ * 			larger elements once the recursion is done with it.
+ * @param	less The comparison on indices.
+ * @tparam	Less A functor taking two indices.
+ */
+template <typename Less>
+void	mergeInsertion(std::vector<size_t> &ids, std::vector<size_t> &partner, Less &less)
+{
+	size_t	half = ids.size() / 2;
+
+	if (ids.size() < 2)
+		return ;
+
+	// Pair up, larger element first
+	std::vector<size_t>	larger(half), smaller(half);
+	for (size_t i = 0; i < half; ++i)
+	{
+		larger[i] = ids[2 * i];
+		smaller[i] = ids[2 * i + 1];
+		if (less(larger[i], smaller[i]))
+			std::swap(larger[i], smaller[i]);
+	}
+
+	// Sort the larger elements, then remember who belongs to whom
+	std::vector<size_t>	sorted(larger);
+	mergeInsertion(sorted, partner, less);
+	for (size_t i = 0; i < half; ++i)
+		partner[larger[i]] = smaller[i];
+
+	// b1 is smaller than a1, it goes first for free
+	std::vector<size_t>	chain;
+	chain.reserve(ids.size());
+	chain.push_back(partner[sorted[0]]);
+	chain.insert(chain.end(), sorted.begin(), sorted.end());
+
+	// Pending elements are b2..b_half, plus the unpaired one as b_(half+1)
+	size_t	pending = half + ids.size() % 2;
+	size_t	done = 1;
+	for (size_t k = 3; done < pending; ++k)
+	{
+		size_t	last = std::min(jacobsthal(k), pending);
+		size_t	cursor = chain.size();
+		for (size_t j = last; j > done; --j)
+		{
+			size_t	elem, bound;
+			if (j > half)
+			{
+				elem = ids.back();
+				bound = chain.size();
+			}
+			else
+			{
+				// a_j is the closest a_j to the left of the previous bound
+				elem = partner[sorted[j - 1]];
+				bound = cursor - 1;
+				while (chain[bound] != sorted[j - 1])
+					--bound;
+			}
+			size_t	low = 0, high = bound;
+			while (low < high)
+			{
+				size_t	mid = low + (high - low) / 2;
+				if (less(elem, chain[mid]))
+					high = mid;
+				else
+					low = mid + 1;
+			}
+			chain.insert(chain.begin() + low, elem);
+			cursor = (j > half) ? chain.size() : bound + 1;
+		}
+		done = last;
+	}
+	ids.swap(chain);
+}
+
 /**
  * @brief	Sorts a container using a merge-insertion sort algorithm.
  * 			This function takes a container (vector or list) and sorts it in place.
- * 			Using a recursive approach, it separates the container into pairs
- * 			(Ford Johnson algorithm), sorts the larger elements, and then
- * 			inserts the smaller elements back into the sorted order.
+ * 			The values are copied once, sorted by index with the Ford-Johnson
+ * 			algorithm (see mergeInsertion) and written back in order.
  * 
  * @param	container The container to sort, which can be a vector or a list.
  * @tparam	Co The type of the container, which must support iterators and value_type.
+ * @return	The number of comparisons made by the merge-insertion.
  */
 template <typename Co>
-void	sortCo(Co &container)
+unsigned long	sortCo(Co &container)
 {
+	typedef typename Co::value_type	T;
+	unsigned long					comparisons = 0;
+
 	if (container.size() <= 1 || isSorted(container))
+		return (0);
+
+	std::vector<T>		values(container.begin(), container.end());
+	std::vector<size_t>	ids(values.size());
+	std::vector<size_t>	partner(values.size());
+	CountingLess<T>		less(&values[0], &comparisons);
+
+	for (size_t i = 0; i < ids.size(); ++i)
+		ids[i] = i;
+	mergeInsertion(ids, partner, less);
+
+	typename Co::iterator	it = container.begin();
+	for (size_t i = 0; i < ids.size(); ++i, ++it)
+		*it = values[ids[i]];
+	return (comparisons);
+}
+
+/**
+ * @brief	Allocation-free Ford-Johnson merge-insertion on element indices.
+ * 			Same algorithm and comparisons as mergeInsertion, but every level
+ * 			works in place in a scratch arena sized once by the caller, and
+ * 			the main chain is a BlockChain, so inserting shifts one block
+ * 			instead of the whole tail.
+ * 
+ * @param	ids The n indices to sort, replaced by their sorted order.
+ * @param	n The number of indices.
+ * @param	scratch Level workspace, 3 * n elements (the recursion uses the
+ * 			part after its own 3 * (n / 2)).
+ * @param	partner Scratch table indexed by element.
+ * @param	chain Main chain, with an arena for at least n elements.
+ * @param	less The comparison on indices.
+ * @tparam	Less A functor taking two indices.
+ */
+template <typename Less>
+void	mergeInsertion(size_t *ids, size_t n, size_t *scratch, size_t *partner,
+	BlockChain &chain, Less &less)
+{
+	size_t	half = n / 2;
+	size_t	*larger = scratch;
+	size_t	*smaller = scratch + half;
+	size_t	*sorted = scratch + 2 * half;
+
+	if (n < 2)
 		return ;
 
-	// Séparer en paires
-	std::vector<typename Co::value_type> pairs;
-	typename Co::iterator it = container.begin();
-	while (it != container.end())
+	for (size_t i = 0; i < half; ++i)
 	{
-		typename Co::iterator first = it++;
-		if (it != container.end())
-		{
-			// Mettre le plus grand devant
-			if (*first < *it)
-				std::iter_swap(first, it);
-			pairs.push_back(*first);
-			++it;
-		}
-		else
+		larger[i] = ids[2 * i];
+		smaller[i] = ids[2 * i + 1];
+		if (less(larger[i], smaller[i]))
+			std::swap(larger[i], smaller[i]);
+	}
+	std::copy(larger, larger + half, sorted);
+	mergeInsertion(sorted, half, scratch + 3 * half, partner, chain, less);
+	for (size_t i = 0; i < half; ++i)
+		partner[larger[i]] = smaller[i];
+
+	// The chain is built in ids, free once the pairs are saved
+	size_t	straggler = ids[n - 1];
+	ids[0] = partner[sorted[0]];
+	std::copy(sorted, sorted + half, ids + 1);
+	chain.assign(ids, half + 1);
+
+	size_t	pending = half + n % 2;
+	size_t	done = 1;
+	for (size_t k = 3; done < pending; ++k)
+	{
+		size_t	last = std::min(jacobsthal(k), pending);
+		size_t	cursor = chain.size();
+		for (size_t j = last; j > done; --j)
 		{
-			pairs.push_back(*first);
+			size_t	elem, bound;
+			if (j > half)
+			{
+				elem = straggler;
+				bound = chain.size();
+			}
+			else
+			{
+				elem = partner[sorted[j - 1]];
+				bound = cursor - 1;
+				while (chain.at(bound) != sorted[j - 1])
+					--bound;
+			}
+			size_t	low = 0, high = bound;
+			while (low < high)
+			{
+				size_t	mid = low + (high - low) / 2;
+				if (less(elem, chain.at(mid)))
+					high = mid;
+				else
+					low = mid + 1;
+			}
+			chain.insert(low, elem);
+			cursor = (j > half) ? chain.size() : bound + 1;
 		}
+		done = last;
 	}
+	chain.flatten(ids);
+}
 
-	// Tri récursif des plus grands de chaque paire
-	Co mainChain(pairs.begin(), pairs.end());
-	sortCo(mainChain);
+/**
+ * @brief	One unit of work of sortIndices: either the merge-insertion of
+ * 			a run (out is NULL) or the merge of two adjacent sorted runs
+ * 			into out.
+ */
+template <typename Less>
+struct SortTask
+{
+	size_t			*ids;
+	size_t			count;
+	size_t			split;
+	size_t			*out;
+	size_t			*scratch;
+	size_t			*partner;
+	size_t			*chainArena;
+	Less			less;
+	unsigned long	comparisons;
 
-	// Insertion des plus petits de chaque paire
-	it = container.begin();
-	typename Co::iterator mainIt = mainChain.begin();
-	std::advance(mainIt, 1); // On saute le premier élément (déjà en place)
-	while (it != container.end())
+	SortTask(const Less &less) : ids(NULL), count(0), split(0), out(NULL), scratch(NULL),
+		partner(NULL), chainArena(NULL), less(less), comparisons(0)
+	{}
+};
+
+/**
+ * @brief	Thread entry point running a SortTask with its own comparison
+ * 			counter.
+ */
+template <typename Less>
+void	*runSortTask(void *arg)
+{
+	SortTask<Less>	*task = static_cast<SortTask<Less> *>(arg);
+
+	task->less.count = &task->comparisons;
+	if (task->out == NULL)
+	{
+		BlockChain	chain;
+		chain.setArena(task->chainArena, task->count);
+		mergeInsertion(task->ids, task->count, task->scratch, task->partner, chain, task->less);
+	}
+	else
 	{
-		typename Co::iterator first = it++;
-		if (it != container.end())
+		std::merge(task->ids, task->ids + task->split, task->ids + task->split,
+			task->ids + task->count, task->out, task->less);
+	}
+	return (NULL);
+}
+
+/**
+ * @brief	Run tasks concurrently, the first one on the calling thread.
+ * 			A task whose thread cannot be started runs on the calling thread
+ * 			too, so the result never depends on thread availability.
+ */
+template <typename Less>
+void	runSortTasks(std::vector<SortTask<Less> > &tasks)
+{
+	std::vector<pthread_t>	tids(tasks.size());
+	std::vector<char>		started(tasks.size(), 0);
+
+	for (size_t t = 1; t < tasks.size(); ++t)
+		started[t] = (pthread_create(&tids[t], NULL, runSortTask<Less>, &tasks[t]) == 0);
+	for (size_t t = 0; t < tasks.size(); ++t)
+	{
+		if (!started[t])
+			runSortTask<Less>(&tasks[t]);
+	}
+	for (size_t t = 1; t < tasks.size(); ++t)
+	{
+		if (started[t])
+			pthread_join(tids[t], NULL);
+	}
+}
+
+/**
+ * @brief	Number of runs sortIndices cuts n indices into: one per thread
+ * 			from PARALLEL_MIN_SIZE elements on, each at least a quarter of
+ * 			that size, otherwise a single one.
+ */
+inline size_t	parallelRuns(size_t n, unsigned int threads)
+{
+	if (threads > 1 && n >= PARALLEL_MIN_SIZE)
+		return (std::min<size_t>(threads, n / (PARALLEL_MIN_SIZE / 4)));
+	return (1);
+}
+
+/**
+ * @brief	Sorts element indices with the allocation-free merge-insertion.
+ * 			The index arena is allocated once before sorting starts.
+ * 			With several threads and at least PARALLEL_MIN_SIZE elements, the
+ * 			indices are cut into one run per thread (see parallelRuns), each
+ * 			run is sorted by merge-insertion on its own thread, and runs are
+ * 			merged pairwise, each round of merges running in parallel too.
+ * 			The sorted values are the same as with one thread, but not the
+ * 			comparisons: the merges add some that a single merge-insertion
+ * 			would not make, so the count can exceed the Ford-Johnson worst
+ * 			case.
+ * 
+ * @param	ids The n indices to sort, replaced by their sorted order.
+ * @param	n The number of indices.
+ * @param	less The comparison on indices, whose counter receives the total
+ * 			number of comparisons.
+ * @param	threads The maximum number of threads to use.
+ * @tparam	Less A functor taking two indices, with a count member.
+ */
+template <typename Less>
+void	sortIndices(size_t *ids, size_t n, Less &less, unsigned int threads)
+{
+	size_t	runs = parallelRuns(n, threads);
+	size_t	length = (n + runs - 1) / runs;
+	size_t	chainSize = BlockChain::arenaSize(length);
+
+	// partner | level scratch | merge buffer | one chain arena per run
+	std::vector<size_t>	arena(5 * n + runs * chainSize);
+	size_t				*partner = &arena[0];
+	size_t				*scratch = partner + n;
+	size_t				*buffer = scratch + 3 * n;
+	size_t				*chains = buffer + n;
+
+	if (runs == 1)
+	{
+		BlockChain	chain;
+		chain.setArena(chains, n);
+		mergeInsertion(ids, n, scratch, partner, chain, less);
+		return ;
+	}
+
+	std::vector<SortTask<Less> >	tasks(runs, SortTask<Less>(less));
+	std::vector<size_t>				bounds(runs + 1, n);
+	for (size_t r = 0; r < runs; ++r)
+	{
+		bounds[r] = r * length;
+		tasks[r].ids = ids + bounds[r];
+		tasks[r].count = std::min(length, n - bounds[r]);
+		tasks[r].scratch = scratch + 3 * bounds[r];
+		tasks[r].partner = partner;
+		tasks[r].chainArena = chains + r * chainSize;
+	}
+	runSortTasks(tasks);
+	for (size_t r = 0; r < runs; ++r)
+		*less.count += tasks[r].comparisons;
+
+	// Pairwise merge rounds, ping-ponging between ids and the buffer
+	size_t	*src = ids, *dst = buffer;
+	while (bounds.size() > 2)
+	{
+		std::vector<SortTask<Less> >	merges;
+		std::vector<size_t>				next;
+		for (size_t r = 0; r + 1 < bounds.size(); r += 2)
 		{
-			// Insérer le plus petit de la paire à la bonne position
-			typename Co::value_type	insertVal = (*first < *it) ? *first : *it;
-			typename Co::iterator 	pos;
-			for (pos = mainChain.begin(); pos != mainChain.end(); ++pos)
+			next.push_back(bounds[r]);
+			SortTask<Less>	task(less);
+			task.ids = src + bounds[r];
+			task.out = dst + bounds[r];
+			if (r + 2 < bounds.size())
+			{
+				task.split = bounds[r + 1] - bounds[r];
+				task.count = bounds[r + 2] - bounds[r];
+			}
+			else
 			{
-				if (insertVal < *pos)
-					break;
+				task.split = bounds[r + 1] - bounds[r];
+				task.count = task.split;
 			}
-			mainChain.insert(pos, insertVal); 
-			++it;
+			merges.push_back(task);
 		}
+		next.push_back(n);
+		runSortTasks(merges);
+		for (size_t t = 0; t < merges.size(); ++t)
+			*less.count += merges[t].comparisons;
+		bounds.swap(next);
+		std::swap(src, dst);
 	}
+	if (src != ids)
+		std::copy(src, src + n, ids);
+}
+
+/**
+ * @brief	Sorts a vector using the allocation-free merge-insertion.
+ * 			Input made of a few ascending or descending runs is merged
+ * 			instead (see sortRuns), with the comparisons of that scan
+ * 			counted. The room for the copy of the values and the indices
+ * 			is allocated before sorting starts and first serves the run
+ * 			merge, as its buffer and its arena; merge-insertion then makes
+ * 			its index arena (see sortIndices) and nothing else.
+ * 
+ * @param	container The vector to sort.
+ * @param	threads The maximum number of threads to use (see sortIndices).
+ * @tparam	T The type of the values.
+ * @return	The number of comparisons made by the merge-insertion.
+ */
+template <typename T>
+unsigned long	sortCo(std::vector<T> &container, unsigned int threads = 1)
+{
+	unsigned long	comparisons = 0;
+	size_t			n = container.size();
+
+	if (n <= 1)
+		return (0);
+
+	std::vector<T>		values(n);
+	std::vector<size_t>	ids(std::max(n, runArenaSize(n)));
 
-	// Copier le résultat dans le container d'origine
-	typename Co::iterator src = mainChain.begin(), dest;
-	for (dest = container.begin(); dest != container.end() && src != mainChain.end(); ++dest, ++src)
+	if (sortRuns(&container[0], n, &ids[0], &values[0], comparisons))
+		return (comparisons);
+
+	CountingLess<T>		less(&values[0], &comparisons);
+
+	std::copy(container.begin(), container.end(), values.begin());
+	for (size_t i = 0; i < n; ++i)
+		ids[i] = i;
+	sortIndices(&ids[0], n, less, threads);
+	for (size_t i = 0; i < n; ++i)
+		container[i] = values[ids[i]];
+	return (comparisons);
+}
+
+/**
+ * @brief	Sorts a list by relinking its own nodes.
+ * 			The merge-insertion runs on indices of the nodes (through
+ * 			iterators, values are neither copied nor moved), then each node
+ * 			is spliced to the back in sorted order. No list node is ever
+ * 			created, so the sort does not touch the allocator past the index
+ * 			arena made up front. Input made of a few ascending or descending
+ * 			runs is merged instead (see sortRuns).
+ * 
+ * @param	container The list to sort.
+ * @param	threads The maximum number of threads to use (see sortIndices).
+ * @tparam	T The type of the values.
+ * @return	The number of comparisons made by the merge-insertion.
+ */
+template <typename T>
+unsigned long	sortCo(std::list<T> &container, unsigned int threads = 1)
+{
+	typedef typename std::list<T>::iterator	It;
+	unsigned long							comparisons = 0;
+	size_t									n = container.size();
+
+	if (n <= 1)
+		return (0);
+	if (sortRuns(container, comparisons))
+		return (comparisons);
+
+	std::vector<It>		nodes(n);
+	std::vector<size_t>	ids(n);
+	IteratorLess<It>	less(&nodes[0], &comparisons);
+
+	It	it = container.begin();
+	for (size_t i = 0; i < n; ++i, ++it)
+	{
+		nodes[i] = it;
+		ids[i] = i;
+	}
+	sortIndices(&ids[0], n, less, threads);
+	for (size_t i = 0; i < n; ++i)
+		container.splice(container.end(), container, nodes[ids[i]]);
+	return (comparisons);
+}
+
+/**
+ * @brief	Merges a sorted batch into a sorted vector, in place. The batch
+ * 			is appended, then both runs are merged with the galloping merge
+ * 			of the natural merge sort; the batch itself, no longer needed,
+ * 			serves as its buffer, so the merge allocates nothing past the
+ * 			growth of the vector. Values of the batch above the whole vector
+ * 			stay where they were appended at the cost of a few comparisons.
+ *
+ * @param	container The sorted vector, receiving the batch.
+ * @param	batch The sorted batch, left in an unspecified state.
+ * @tparam	T The type of the values.
+ * @return	The number of comparisons made.
+ */
+template <typename T>
+unsigned long	mergeSorted(std::vector<T> &container, std::vector<T> &batch)
+{
+	unsigned long	comparisons = 0;
+	ValueLess<T>	less(&comparisons);
+	size_t			n = container.size();
+
+	if (batch.empty())
+		return (0);
+	container.insert(container.end(), batch.begin(), batch.end());
+	if (n > 0)
+		mergeAdjacent(&container[0], n, batch.size(), &batch[0], less);
+	return (comparisons);
+}
+
+/**
+ * @brief	Merges a sorted batch into a sorted list by splicing its nodes.
+ * 			The batch is walked from its largest value down, each node being
+ * 			spliced after the last value of the list not above it, found by
+ * 			walking back from the previous insertion point. Appending values
+ * 			at the top of the range so only visits the end of the list, and
+ * 			what is left once the front is reached is spliced at once. The
+ * 			longer list is taken as the destination, lists swapping in
+ * 			constant time, so the shorter one is the one walked value by
+ * 			value.
+ *
+ * @param	container The sorted list, receiving the nodes of the batch.
+ * @param	batch The sorted batch, left empty.
+ * @tparam	T The type of the values.
+ * @return	The number of comparisons made.
+ */
+template <typename T>
+unsigned long	mergeSorted(std::list<T> &container, std::list<T> &batch)
+{
+	typedef typename std::list<T>::iterator	It;
+	unsigned long							comparisons = 0;
+	ValueLess<T>							less(&comparisons);
+	It										pos;
+
+	if (batch.size() > container.size())
+		container.swap(batch);
+	pos = container.end();
+	while (!batch.empty())
 	{
-		*dest = *src;
+		if (pos == container.begin())
+		{
+			container.splice(pos, batch);
+			break ;
+		}
+
+		It	last = --batch.end();
+		It	prev = pos;
+		while (pos != container.begin() && less(*last, *--prev))
+			pos = prev;
+		container.splice(pos, batch, last);
+		pos = last;
 	}
+	return (comparisons);
 }
 
 /**
- * @brief	Prints the contents of a container to the standard output.
+ * @brief	Strict weak ordering putting the largest values first, counting
+ * 			every comparison made.
+ *
+ * @tparam	T The type of the values.
+ */
+template <typename T>
+struct ValueGreater
+{
+	unsigned long	*count;
+
+	ValueGreater(unsigned long *count) : count(count)
+	{}
+
+	bool	operator()(const T &a, const T &b) const
+	{
+		++*count;
+		return (b < a);
+	}
+};
+
+/**
+ * @brief	Selects the k first values of a range in the order of less,
+ * 			without sorting the rest. A heap holds the k best values seen so
+ * 			far, its root being the worst of them: each further value costs
+ * 			one comparison against the root, and only the values that beat
+ * 			it go through the heap. Once the range is read, the k values are
+ * 			sorted with merge-insertion.
+ *
+ * @param	first The beginning of the range.
+ * @param	last The end of the range.
+ * @param	k The number of values to keep.
+ * @param	less The order, whose comparisons are counted.
+ * @param	comparisons Incremented by the comparisons made.
+ * @tparam	It The type of the iterators.
+ * @tparam	Less The type of the order.
+ * @return	The k first values in ascending order, the whole range if it is
+ * 			shorter.
+ */
+template <typename It, typename Less>
+std::vector<unsigned int>	selectFirst(It first, It last, size_t k, Less less,
+	unsigned long &comparisons)
+{
+	std::vector<unsigned int>	heap;
+
+	if (k == 0)
+		return (heap);
+	for (; first != last; ++first)
+	{
+		if (heap.size() < k)
+		{
+			heap.push_back(*first);
+			std::push_heap(heap.begin(), heap.end(), less);
+		}
+		else if (less(*first, heap.front()))
+		{
+			std::pop_heap(heap.begin(), heap.end(), less);
+			heap.back() = *first;
+			std::push_heap(heap.begin(), heap.end(), less);
+		}
+	}
+	comparisons += sortCo(heap);
+	return (heap);
+}
+
+/**
+ * @brief	Prints a label and the contents of a container on one line of
+ * 			the standard output. Values are formatted into a buffer written
+ * 			with write(2), so std::cout is flushed first to keep the output
+ * 			in order. The buffer is the caller's, reused from one call to
+ * 			the next, and left empty.
  * 
+ * @param	out The buffer on the standard output.
+ * @param	label The text printed before the values.
+ * @param	container The container to print, holding unsigned int values.
+ * @param	limit The number of values printed before the rest is cut to
+ * 			"[...]"; with 0, nothing at all is printed.
  * @tparam	Co The type of the container, which must support iterators.
  */
 template <typename Co>
-void	printContainers(const Co &container)
+void	printContainers(OutputBuffer &out, const char *label, const Co &container, size_t limit)
 {
-	typename Co::const_iterator it;
+	typename Co::const_iterator	it;
+	size_t						printed = 0;
 
+	if (limit == 0)
+		return ;
+	std::cout.flush();
+	out.putString(label);
 	for (it = container.begin(); it != container.end(); ++it)
 	{
-		std::cout << *it << " ";
+		if (printed++ == limit)
+		{
+			out.putString("[...]");
+			break ;
+		}
+		out.putValue(*it, ' ');
 	}
-	std::cout << std::endl;
+	out.putString("\n");
+	out.flush();
 }
 
-
 #endif
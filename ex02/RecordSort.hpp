@@ -0,0 +1,195 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   RecordSort.hpp                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: benpicar <benpicar@student.42mulhouse.fr>  +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 18:10:27 by benpicar          #+#    #+#             */
+/*   Updated: 2026/10/19 18:10:27 by benpicar         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma once
+
+#ifndef RECORDSORT_HPP
+# define RECORDSORT_HPP
+
+# include "PmergeMe.hpp"
+# include <functional>
+
+/* Records ahead of the current one fetched while the permutation is applied */
+# define RECORD_PREFETCH_DISTANCE 8
+
+/*
+ * Indirect merge-insertion on records: a key plus a payload of any size.
+ * The key of every record is extracted once into a compact array, the
+ * merge-insertion sorts record indices comparing those keys only, and the
+ * records are moved once, at the end. A key policy is a functor with a Key
+ * type and a call operator extracting it:
+ *
+ *	typedef K	Key;
+ *	Key			operator()(const Record &record) const;
+ *
+ * Keys are ordered by a comparator policy, std::less<Key> for the natural
+ * order.
+ */
+
+/**
+ * @brief	Strict weak ordering on record indices, comparing the extracted
+ * 			keys and counting every comparison made. In stable mode, equal
+ * 			keys are ordered by index: merge-insertion is not stable, but
+ * 			under this total order its result is the stable one. The keys
+ * 			are then compared three ways, so that a tie falls back to the
+ * 			indices; with a less-than comparator, this calls compare a
+ * 			second time whenever the first index is the smaller and its key
+ * 			is not less, equal keys or not. Each call is still counted as
+ * 			one comparison of two records, the count staying that of the
+ * 			merge-insertion.
+ *
+ * @tparam	Key The type of the keys.
+ * @tparam	Compare The comparator on keys.
+ */
+template <typename Key, typename Compare>
+struct KeyLess
+{
+	const Key		*keys;
+	Compare			compare;
+	bool			stable;
+	unsigned long	*count;
+
+	KeyLess(const Key *keys, Compare compare, bool stable, unsigned long *count) : keys(keys),
+		compare(compare), stable(stable), count(count)
+	{}
+
+	bool	operator()(size_t a, size_t b) const
+	{
+		++*count;
+		if (compare(keys[a], keys[b]))
+			return (true);
+		if (!stable || a >= b)
+			return (false);
+		return (!compare(keys[b], keys[a]));
+	}
+};
+
+/**
+ * @brief	Whether keys are already in order, equal keys included: such
+ * 			records are left as they are, stable mode or not, after n - 1
+ * 			comparisons.
+ */
+template <typename Key, typename Compare>
+bool	keysSorted(const std::vector<Key> &keys, Compare compare, unsigned long &comparisons)
+{
+	for (size_t i = 1; i < keys.size(); ++i)
+	{
+		++comparisons;
+		if (compare(keys[i], keys[i - 1]))
+			return (false);
+	}
+	return (true);
+}
+
+/**
+ * @brief	Sorts a vector of records by key. Only the keys and the indices
+ * 			go through the merge-insertion (see sortIndices); the records
+ * 			are then gathered in sorted order into a new vector, written
+ * 			front to back while the records read a few steps ahead are
+ * 			prefetched, so each record is copied exactly once.
+ *
+ * @param	records The records to sort.
+ * @param	keyOf The key policy.
+ * @param	compare The comparator on keys.
+ * @param	stable Whether records with equal keys keep their order.
+ * @param	threads The maximum number of threads to use.
+ * @tparam	Record The type of the records.
+ * @tparam	KeyOf The type of the key policy.
+ * @tparam	Compare The type of the comparator.
+ * @return	The number of comparisons made between keys.
+ */
+template <typename Record, typename KeyOf, typename Compare>
+unsigned long	sortRecords(std::vector<Record> &records, KeyOf keyOf, Compare compare,
+	bool stable = false, unsigned int threads = 1)
+{
+	typedef typename KeyOf::Key	Key;
+	unsigned long				comparisons = 0;
+	size_t						n = records.size();
+
+	if (n <= 1)
+		return (0);
+
+	std::vector<Key>		keys(n);
+	std::vector<size_t>		ids(n);
+	KeyLess<Key, Compare>	less(&keys[0], compare, stable, &comparisons);
+
+	for (size_t i = 0; i < n; ++i)
+	{
+		keys[i] = keyOf(records[i]);
+		ids[i] = i;
+	}
+	if (keysSorted(keys, compare, comparisons))
+		return (comparisons);
+	sortIndices(&ids[0], n, less, threads);
+
+	std::vector<Record>	sorted;
+	sorted.reserve(n);
+	for (size_t i = 0; i < n; ++i)
+	{
+#if defined(__GNUC__)
+		if (i + RECORD_PREFETCH_DISTANCE < n)
+			__builtin_prefetch(&records[ids[i + RECORD_PREFETCH_DISTANCE]]);
+#endif
+		sorted.push_back(records[ids[i]]);
+	}
+	records.swap(sorted);
+	return (comparisons);
+}
+
+/**
+ * @brief	Sorts a list of records by key by relinking its nodes: the
+ * 			keys are extracted as for vectors, then each node is spliced to
+ * 			the back in sorted order, so records are never copied at all.
+ *
+ * @param	records The records to sort.
+ * @param	keyOf The key policy.
+ * @param	compare The comparator on keys.
+ * @param	stable Whether records with equal keys keep their order.
+ * @param	threads The maximum number of threads to use.
+ * @tparam	Record The type of the records.
+ * @tparam	KeyOf The type of the key policy.
+ * @tparam	Compare The type of the comparator.
+ * @return	The number of comparisons made between keys.
+ */
+template <typename Record, typename KeyOf, typename Compare>
+unsigned long	sortRecords(std::list<Record> &records, KeyOf keyOf, Compare compare,
+	bool stable = false, unsigned int threads = 1)
+{
+	typedef typename KeyOf::Key					Key;
+	typedef typename std::list<Record>::iterator	It;
+	unsigned long								comparisons = 0;
+	size_t										n = records.size();
+
+	if (n <= 1)
+		return (0);
+
+	std::vector<Key>		keys(n);
+	std::vector<It>			nodes(n);
+	std::vector<size_t>		ids(n);
+	KeyLess<Key, Compare>	less(&keys[0], compare, stable, &comparisons);
+
+	It	it = records.begin();
+	for (size_t i = 0; i < n; ++i, ++it)
+	{
+		keys[i] = keyOf(*it);
+		nodes[i] = it;
+		ids[i] = i;
+	}
+	if (keysSorted(keys, compare, comparisons))
+		return (comparisons);
+	sortIndices(&ids[0], n, less, threads);
+	for (size_t i = 0; i < n; ++i)
+		records.splice(records.end(), records, nodes[ids[i]]);
+	return (comparisons);
+}
+
+#endif
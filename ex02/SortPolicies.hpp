@@ -0,0 +1,400 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   SortPolicies.hpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: benpicar <benpicar@student.42mulhouse.fr>  +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 14:02:11 by benpicar          #+#    #+#             */
+/*   Updated: 2026/10/19 14:02:11 by benpicar         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma once
+
+#ifndef SORTPOLICIES_HPP
+# define SORTPOLICIES_HPP
+
+# include "PmergeMe.hpp"
+
+/* Buckets at most this large are finished by merge-insertion in HybridSort */
+# define HYBRID_CUTOFF 64
+
+/* Rows (and columns) of the tiles sorted by NetworkSort */
+# define NETWORK_ROWS 8
+
+/*
+ * Sort policies. Each one exposes the same static interface, so that code
+ * picking an engine is written once as a template on the policy:
+ *
+ *	static const char		*name();
+ *	static size_t			runs(size_t n, unsigned int threads);
+ *	static unsigned long	sort(std::vector<T> &container, unsigned int threads);
+ *	static unsigned long	sort(std::list<T> &container, unsigned int threads);
+ *
+ * sort() returns the number of comparisons it made between values. runs()
+ * tells how many runs sorted apart and merged afterwards those comparisons
+ * come from, 1 for a single sort.
+ * RadixSort and HybridSort read the bytes of the values, so they only
+ * accept unsigned integer types.
+ */
+
+/**
+ * @brief	Sorts a list with a vector engine: the values are copied out,
+ * 			sorted, and written back into the existing nodes, so no node is
+ * 			created.
+ *
+ * @tparam	Policy The sort policy used on the copy.
+ */
+template <typename Policy, typename T>
+unsigned long	sortListValues(std::list<T> &container, unsigned int threads)
+{
+	if (container.size() <= 1 || isSorted(container))
+		return (0);
+
+	std::vector<T>	values(container.begin(), container.end());
+	unsigned long	comparisons = Policy::sort(values, threads);
+
+	std::copy(values.begin(), values.end(), container.begin());
+	return (comparisons);
+}
+
+/**
+ * @brief	The Ford-Johnson merge-insertion of sortCo: fewest comparisons,
+ * 			the only engine to use more than one thread.
+ */
+struct MergeInsertionSort
+{
+	static const char	*name()
+	{
+		return ("merge-insertion");
+	}
+
+	static size_t	runs(size_t n, unsigned int threads)
+	{
+		return (parallelRuns(n, threads));
+	}
+
+	template <typename T>
+	static unsigned long	sort(std::vector<T> &container, unsigned int threads)
+	{
+		return (sortCo(container, threads));
+	}
+
+	template <typename T>
+	static unsigned long	sort(std::list<T> &container, unsigned int threads)
+	{
+		return (sortCo(container, threads));
+	}
+};
+
+/**
+ * @brief	Least significant digit radix sort, one byte per pass. The
+ * 			counts of every pass are gathered in a single read of the input,
+ * 			and a pass whose byte is the same in all values is skipped.
+ * 			Makes no comparison.
+ */
+struct RadixSort
+{
+	static const char	*name()
+	{
+		return ("radix");
+	}
+
+	static size_t	runs(size_t n, unsigned int threads)
+	{
+		(void)n;
+		(void)threads;
+		return (1);
+	}
+
+	template <typename T>
+	static unsigned long	sort(std::vector<T> &container, unsigned int threads)
+	{
+		size_t	n = container.size();
+
+		(void)threads;
+		if (n <= 1 || isSorted(container))
+			return (0);
+
+		std::vector<size_t>	counts(sizeof(T) * 256, 0);
+		std::vector<T>		buffer(n);
+		T					*src = &container[0];
+		T					*dst = &buffer[0];
+
+		for (size_t i = 0; i < n; ++i)
+		{
+			for (size_t pass = 0; pass < sizeof(T); ++pass)
+				counts[pass * 256 + ((src[i] >> (pass * 8)) & 0xff)]++;
+		}
+		for (size_t pass = 0; pass < sizeof(T); ++pass)
+		{
+			size_t	*count = &counts[pass * 256];
+			size_t	offset = 0;
+
+			if (count[(src[0] >> (pass * 8)) & 0xff] == n)
+				continue ;
+			for (size_t digit = 0; digit < 256; ++digit)
+			{
+				size_t	c = count[digit];
+				count[digit] = offset;
+				offset += c;
+			}
+			for (size_t i = 0; i < n; ++i)
+				dst[count[(src[i] >> (pass * 8)) & 0xff]++] = src[i];
+			std::swap(src, dst);
+		}
+		if (src != &container[0])
+			std::copy(src, src + n, &container[0]);
+		return (0);
+	}
+
+	template <typename T>
+	static unsigned long	sort(std::list<T> &container, unsigned int threads)
+	{
+		return (sortListValues<RadixSort>(container, threads));
+	}
+};
+
+/**
+ * @brief	Applies Batcher's 19-comparator network for 8 values to the
+ * 			NETWORK_ROWS rows of a tile, column by column. The inner loop
+ * 			runs over contiguous values with a branchless min/max, which the
+ * 			compiler can turn into vector instructions.
+ *
+ * @param	tile NETWORK_ROWS rows of width values, row after row.
+ * @param	width The number of columns, each one sorted independently.
+ * @return	The number of comparisons made.
+ */
+template <typename T>
+unsigned long	sortColumns(T *tile, size_t width)
+{
+	static const unsigned char	network[19][2] = {
+		{0, 2}, {1, 3}, {4, 6}, {5, 7},
+		{0, 4}, {1, 5}, {2, 6}, {3, 7},
+		{0, 1}, {2, 3}, {4, 5}, {6, 7},
+		{2, 4}, {3, 5},
+		{1, 4}, {3, 6},
+		{1, 2}, {3, 4}, {5, 6}
+	};
+
+	for (size_t c = 0; c < 19; ++c)
+	{
+		T	*low = tile + network[c][0] * width;
+		T	*high = tile + network[c][1] * width;
+
+		for (size_t k = 0; k < width; ++k)
+		{
+			T	a = low[k];
+			T	b = high[k];
+			low[k] = (b < a) ? b : a;
+			high[k] = (b < a) ? a : b;
+		}
+	}
+	return (19 * width);
+}
+
+/**
+ * @brief	Merges two adjacent sorted runs without a data-dependent branch
+ * 			in the loop body.
+ *
+ * @return	The number of comparisons made.
+ */
+template <typename T>
+unsigned long	mergeRuns(const T *src, size_t mid, size_t end, T *dst)
+{
+	size_t	i = 0, j = mid, k = 0;
+
+	while (i < mid && j < end)
+	{
+		T		a = src[i];
+		T		b = src[j];
+		bool	right = b < a;
+
+		dst[k++] = right ? b : a;
+		j += right;
+		i += !right;
+	}
+	unsigned long	comparisons = k;
+	while (i < mid)
+		dst[k++] = src[i++];
+	while (j < end)
+		dst[k++] = src[j++];
+	return (comparisons);
+}
+
+/**
+ * @brief	Sorts tiles of NETWORK_ROWS x NETWORK_ROWS values with a
+ * 			sorting network applied to whole rows, transposes each tile so
+ * 			its sorted columns become runs of NETWORK_ROWS values, then
+ * 			merges the runs bottom-up. What is left past the last tile is
+ * 			cut into runs of NETWORK_ROWS sorted by the same network, plus
+ * 			a short run finished by insertion.
+ */
+struct NetworkSort
+{
+	static const char	*name()
+	{
+		return ("network");
+	}
+
+	static size_t	runs(size_t n, unsigned int threads)
+	{
+		(void)n;
+		(void)threads;
+		return (1);
+	}
+
+	template <typename T>
+	static unsigned long	sort(std::vector<T> &container, unsigned int threads)
+	{
+		const size_t	tile = NETWORK_ROWS * NETWORK_ROWS;
+		size_t			n = container.size();
+		unsigned long	comparisons = 0;
+
+		(void)threads;
+		if (n <= 1 || isSorted(container))
+			return (0);
+
+		std::vector<T>	buffer(n);
+		T				*src = &container[0];
+		T				*dst = &buffer[0];
+		size_t			i = 0;
+
+		for (; i + tile <= n; i += tile)
+		{
+			comparisons += sortColumns(src + i, NETWORK_ROWS);
+			for (size_t r = 0; r < NETWORK_ROWS; ++r)
+			{
+				for (size_t c = r + 1; c < NETWORK_ROWS; ++c)
+					std::swap(src[i + r * NETWORK_ROWS + c], src[i + c * NETWORK_ROWS + r]);
+			}
+		}
+		for (; i + NETWORK_ROWS <= n; i += NETWORK_ROWS)
+			comparisons += sortColumns(src + i, 1);
+		for (size_t j = i + 1; j < n; ++j)
+		{
+			T		value = src[j];
+			size_t	k = j;
+
+			while (k > i && (++comparisons, value < src[k - 1]))
+			{
+				src[k] = src[k - 1];
+				--k;
+			}
+			src[k] = value;
+		}
+
+		for (size_t run = NETWORK_ROWS; run < n; run *= 2)
+		{
+			for (size_t start = 0; start < n; start += 2 * run)
+			{
+				size_t	mid = std::min(run, n - start);
+				size_t	end = std::min(2 * run, n - start);
+				comparisons += mergeRuns(src + start, mid, end, dst + start);
+			}
+			std::swap(src, dst);
+		}
+		if (src != &container[0])
+			std::copy(src, src + n, &container[0]);
+		return (comparisons);
+	}
+
+	template <typename T>
+	static unsigned long	sort(std::list<T> &container, unsigned int threads)
+	{
+		return (sortListValues<NetworkSort>(container, threads));
+	}
+};
+
+/**
+ * @brief	Most significant digit radix sort that hands every bucket of at
+ * 			most HYBRID_CUTOFF values to merge-insertion: another counting
+ * 			pass over 256 digits costs more than the few comparisons such a
+ * 			bucket needs. All buffers are allocated once.
+ */
+struct HybridSort
+{
+	static const char	*name()
+	{
+		return ("hybrid");
+	}
+
+	static size_t	runs(size_t n, unsigned int threads)
+	{
+		(void)n;
+		(void)threads;
+		return (1);
+	}
+
+	template <typename T>
+	static unsigned long	sort(std::vector<T> &container, unsigned int threads)
+	{
+		size_t			n = container.size();
+		unsigned long	comparisons = 0;
+
+		(void)threads;
+		if (n <= 1 || isSorted(container))
+			return (0);
+
+		std::vector<T>		buffer(n);
+		// ids | partner | level scratch | chain, sized for one bucket
+		std::vector<size_t>	arena(5 * HYBRID_CUTOFF + BlockChain::arenaSize(HYBRID_CUTOFF));
+
+		sortBucket(&container[0], &buffer[0], n, (sizeof(T) - 1) * 8, &arena[0], comparisons);
+		return (comparisons);
+	}
+
+	template <typename T>
+	static unsigned long	sort(std::list<T> &container, unsigned int threads)
+	{
+		return (sortListValues<HybridSort>(container, threads));
+	}
+
+	private:
+		template <typename T>
+		static void	sortBucket(T *data, T *buffer, size_t n, int shift, size_t *arena,
+			unsigned long &comparisons)
+		{
+			if (n <= 1)
+				return ;
+			if (n <= HYBRID_CUTOFF)
+			{
+				size_t			*ids = arena;
+				BlockChain		chain;
+				CountingLess<T>	less(data, &comparisons);
+
+				for (size_t i = 0; i < n; ++i)
+					ids[i] = i;
+				chain.setArena(arena + 5 * HYBRID_CUTOFF, HYBRID_CUTOFF);
+				mergeInsertion(ids, n, arena + 2 * HYBRID_CUTOFF, arena + HYBRID_CUTOFF, chain, less);
+				for (size_t i = 0; i < n; ++i)
+					buffer[i] = data[ids[i]];
+				std::copy(buffer, buffer + n, data);
+				return ;
+			}
+			if (shift < 0)
+				return ;
+
+			size_t	starts[257] = {0};
+
+			for (size_t i = 0; i < n; ++i)
+				starts[((data[i] >> shift) & 0xff) + 1]++;
+			for (size_t digit = 0; digit < 256; ++digit)
+				starts[digit + 1] += starts[digit];
+
+			size_t	next[256];
+			std::copy(starts, starts + 256, next);
+			for (size_t i = 0; i < n; ++i)
+				buffer[next[(data[i] >> shift) & 0xff]++] = data[i];
+			std::copy(buffer, buffer + n, data);
+
+			for (size_t digit = 0; digit < 256; ++digit)
+			{
+				size_t	size = starts[digit + 1] - starts[digit];
+				sortBucket(data + starts[digit], buffer, size, shift - 8, arena, comparisons);
+			}
+		}
+};
+
+#endif
@@ -0,0 +1,492 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   bench.cpp                                          :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: benpicar <benpicar@student.42mulhouse.fr>  +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 17:02:45 by benpicar          #+#    #+#             */
+/*   Updated: 2026/10/19 17:02:45 by benpicar         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "SortPolicies.hpp"
+#include "RecordSort.hpp"
+#include "Profiler.hpp"
+#include <string>
+#include <sstream>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+
+/*
+ * Benchmark for the PmergeMe sort strategies.
+ * For every input distribution, size, container and strategy, the input is
+ * generated once from the seed, then sorted warm-up times and trials times,
+ * each time from a fresh copy. Trials are timed on the monotonic wall clock;
+ * the median and p99 are reported with the comparisons and heap allocations
+ * of one sort. Every result is checked against std::sort, and the tool exits
+ * with 1 on any mismatch. --csv prints one CSV line per case instead.
+ * --payloads adds records of that many bytes, a key and a payload, sorted
+ * indirectly (see RecordSort.hpp) and checked against a stable sort: the
+ * strategies are then named indirect-BYTES and indirect-stable-BYTES.
+ */
+
+struct Options
+{
+	std::vector<size_t>			sizes;
+	std::vector<std::string>	distributions;
+	std::vector<std::string>	strategies;
+	std::vector<std::string>	containers;
+	std::vector<size_t>			payloads;
+	size_t						trials;
+	size_t						warmup;
+	unsigned int				seed;
+	unsigned int				threads;
+	bool						csv;
+};
+
+struct Result
+{
+	double			median;
+	double			p99;
+	unsigned long	comparisons;
+	unsigned long	allocations;
+	bool			sorted;
+};
+
+/**
+ * @brief	A record of the given size: its key, its rank in the input, which
+ * 			tells whether equal keys kept their order, and the payload.
+ */
+template <size_t Bytes>
+struct Record
+{
+	unsigned int	key;
+	unsigned int	rank;
+	char			payload[Bytes - 2 * sizeof(unsigned int)];
+};
+
+template <typename R>
+struct RecordKey
+{
+	typedef unsigned int	Key;
+
+	Key	operator()(const R &record) const
+	{
+		return (record.key);
+	}
+};
+
+/**
+ * @brief	Small deterministic generator (xorshift), so a seed always gives
+ * 			the same inputs whatever the libc.
+ */
+static unsigned int	nextRandom(unsigned int &state)
+{
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+	return (state);
+}
+
+/**
+ * @brief	Monotonic wall clock, in nanoseconds.
+ */
+static double	now()
+{
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec * 1e9 + ts.tv_nsec);
+}
+
+static double	percentile(std::vector<double> &sorted, double p)
+{
+	size_t	idx = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+
+	return (sorted[idx]);
+}
+
+/**
+ * @brief	Generate n values following a named distribution.
+ *
+ * @return	false if the distribution is unknown.
+ */
+static bool	generate(const std::string &name, size_t n, unsigned int seed,
+	std::vector<unsigned int> &values)
+{
+	unsigned int	state = seed;
+
+	values.resize(n);
+	for (size_t i = 0; i < n; ++i)
+		values[i] = nextRandom(state);
+	if (name == "random")
+		return (true);
+	if (name == "few-unique")
+	{
+		for (size_t i = 0; i < n; ++i)
+			values[i] %= 16;
+		return (true);
+	}
+	std::sort(values.begin(), values.end());
+	if (name == "sorted")
+		return (true);
+	if (name == "reverse")
+		std::reverse(values.begin(), values.end());
+	else if (name == "organ-pipe")
+	{
+		// Even ranks ascending, then odd ranks descending
+		std::vector<unsigned int>	sorted(values);
+		size_t						half = (n + 1) / 2;
+		for (size_t i = 0; i < n; ++i)
+			values[i < half ? i : n - 1 - (i - half)] = sorted[i < half ? 2 * i : 2 * (i - half) + 1];
+	}
+	else if (name == "nearly-sorted")
+	{
+		// One value in a hundred swapped with a random other
+		for (size_t k = 0; k < n / 100 + 1 && n > 1; ++k)
+			std::swap(values[nextRandom(state) % n], values[nextRandom(state) % n]);
+	}
+	else
+		return (false);
+	return (true);
+}
+
+/**
+ * @brief	Run the trials of one case.
+ *
+ * @tparam	Policy The sort policy to run.
+ * @tparam	Co The container type.
+ */
+template <typename Policy, typename Co>
+static Result	measure(const std::vector<unsigned int> &input, const std::vector<unsigned int> &expected,
+	const Options &opt)
+{
+	Result				result;
+	std::vector<double>	times;
+
+	result.sorted = true;
+	for (size_t t = 0; t < opt.warmup + opt.trials; ++t)
+	{
+		Co				container(input.begin(), input.end());
+		unsigned long	allocations = Profiler::allocations();
+		double			start = now();
+
+		result.comparisons = Policy::sort(container, opt.threads);
+		double			elapsed = now() - start;
+
+		result.allocations = Profiler::allocations() - allocations;
+		if (t >= opt.warmup)
+			times.push_back(elapsed);
+		if (t == 0)
+			result.sorted = std::equal(container.begin(), container.end(), expected.begin());
+	}
+	std::sort(times.begin(), times.end());
+	result.median = percentile(times, 0.50);
+	result.p99 = percentile(times, 0.99);
+	return (result);
+}
+
+/**
+ * @brief	Run the trials of one record case. The input is sorted into
+ * 			records by key, whose ranks must match expected in stable mode.
+ *
+ * @tparam	Bytes The size of the records.
+ * @tparam	Co The container type, holding records.
+ */
+template <size_t Bytes, typename Co>
+static Result	measureRecords(const std::vector<unsigned int> &input,
+	const std::vector<unsigned int> &expected, const std::vector<unsigned int> &ranks,
+	bool stable, const Options &opt)
+{
+	Result				result;
+	std::vector<double>	times;
+	Co					records;
+
+	for (size_t i = 0; i < input.size(); ++i)
+	{
+		Record<Bytes>	record;
+		record.key = input[i];
+		record.rank = static_cast<unsigned int>(i);
+		std::memset(record.payload, static_cast<int>(i), sizeof(record.payload));
+		records.push_back(record);
+	}
+	result.sorted = true;
+	for (size_t t = 0; t < opt.warmup + opt.trials; ++t)
+	{
+		Co				container(records);
+		unsigned long	allocations = Profiler::allocations();
+		double			start = now();
+
+		result.comparisons = sortRecords(container, RecordKey<Record<Bytes> >(),
+			std::less<unsigned int>(), stable, opt.threads);
+		double			elapsed = now() - start;
+
+		result.allocations = Profiler::allocations() - allocations;
+		if (t >= opt.warmup)
+			times.push_back(elapsed);
+		if (t != 0)
+			continue ;
+
+		typename Co::const_iterator	it = container.begin();
+		for (size_t i = 0; it != container.end(); ++it, ++i)
+		{
+			if (it->key != expected[i] || (stable && it->rank != ranks[i])
+				|| it->payload[0] != static_cast<char>(it->rank))
+				result.sorted = false;
+		}
+	}
+	std::sort(times.begin(), times.end());
+	result.median = percentile(times, 0.50);
+	result.p99 = percentile(times, 0.99);
+	return (result);
+}
+
+/**
+ * @brief	Run a record case for one of the supported record sizes.
+ *
+ * @return	false if the size is not supported.
+ */
+template <typename Co64, typename Co128, typename Co256>
+static bool	measurePayload(size_t bytes, const std::vector<unsigned int> &input,
+	const std::vector<unsigned int> &expected, const std::vector<unsigned int> &ranks,
+	bool stable, const Options &opt, Result &result)
+{
+	if (bytes == 64)
+		result = measureRecords<64, Co64>(input, expected, ranks, stable, opt);
+	else if (bytes == 128)
+		result = measureRecords<128, Co128>(input, expected, ranks, stable, opt);
+	else if (bytes == 256)
+		result = measureRecords<256, Co256>(input, expected, ranks, stable, opt);
+	else
+		return (false);
+	return (true);
+}
+
+template <typename Co>
+static bool	measureStrategy(const std::string &name, const std::vector<unsigned int> &input,
+	const std::vector<unsigned int> &expected, const Options &opt, Result &result)
+{
+	if (name == "merge")
+		result = measure<MergeInsertionSort, Co>(input, expected, opt);
+	else if (name == "radix")
+		result = measure<RadixSort, Co>(input, expected, opt);
+	else if (name == "network")
+		result = measure<NetworkSort, Co>(input, expected, opt);
+	else if (name == "hybrid")
+		result = measure<HybridSort, Co>(input, expected, opt);
+	else
+		return (false);
+	return (true);
+}
+
+static std::vector<std::string>	split(const std::string &list)
+{
+	std::vector<std::string>	items;
+	std::istringstream			in(list);
+	std::string					item;
+
+	while (std::getline(in, item, ','))
+	{
+		if (!item.empty())
+			items.push_back(item);
+	}
+	return (items);
+}
+
+/**
+ * @brief	Print the result of one case, as text or as a CSV line.
+ */
+static void	printResult(const Options &opt, const std::string &distribution, size_t size,
+	const std::string &container, const std::string &strategy, const Result &r)
+{
+	if (opt.csv)
+		std::cout << distribution << "," << size << "," << container
+				  << "," << strategy << "," << opt.trials << ","
+				  << static_cast<long long>(r.median) << "," << static_cast<long long>(r.p99)
+				  << "," << r.comparisons << "," << r.allocations << std::endl;
+	else
+		std::cout << GREEN << distribution << " " << size << " "
+				  << container << " " << strategy << NC
+				  << ": median " << r.median / 1000.0 << " us, p99 " << r.p99 / 1000.0
+				  << " us, " << r.comparisons << " comparisons, " << r.allocations
+				  << " allocations" << std::endl;
+}
+
+/**
+ * @brief	Ranks of the input values in stable sorted order.
+ */
+struct RankLess
+{
+	const std::vector<unsigned int>	*values;
+
+	bool	operator()(unsigned int a, unsigned int b) const
+	{
+		return ((*values)[a] < (*values)[b]);
+	}
+};
+
+static bool	parseOption(const std::string &arg, const char *name, std::string &value)
+{
+	std::string	prefix = std::string("--") + name + "=";
+
+	if (arg.compare(0, prefix.length(), prefix) != 0)
+		return (false);
+	value = arg.substr(prefix.length());
+	return (true);
+}
+
+static bool	parseOptions(int ac, char **av, Options &opt)
+{
+	std::string	value;
+
+	for (int i = 1; i < ac; ++i)
+	{
+		std::string	arg(av[i]);
+		if (parseOption(arg, "sizes", value))
+		{
+			std::vector<std::string>	sizes = split(value);
+			opt.sizes.clear();
+			for (size_t s = 0; s < sizes.size(); ++s)
+				opt.sizes.push_back(static_cast<size_t>(std::strtod(sizes[s].c_str(), NULL)));
+		}
+		else if (parseOption(arg, "distributions", value))
+			opt.distributions = split(value);
+		else if (parseOption(arg, "strategies", value))
+			opt.strategies = split(value);
+		else if (parseOption(arg, "containers", value))
+			opt.containers = split(value);
+		else if (parseOption(arg, "payloads", value))
+		{
+			std::vector<std::string>	payloads = split(value);
+			opt.payloads.clear();
+			for (size_t p = 0; p < payloads.size(); ++p)
+				opt.payloads.push_back(std::strtoul(payloads[p].c_str(), NULL, 10));
+		}
+		else if (parseOption(arg, "trials", value))
+			opt.trials = std::max<size_t>(std::strtoul(value.c_str(), NULL, 10), 1);
+		else if (parseOption(arg, "warmup", value))
+			opt.warmup = std::strtoul(value.c_str(), NULL, 10);
+		else if (parseOption(arg, "seed", value))
+			opt.seed = std::max<unsigned int>(std::strtoul(value.c_str(), NULL, 10), 1);
+		else if (parseOption(arg, "threads", value))
+			opt.threads = std::max<unsigned int>(std::strtoul(value.c_str(), NULL, 10), 1);
+		else if (arg == "--csv")
+			opt.csv = true;
+		else
+			return (false);
+	}
+	return (true);
+}
+
+int	main(int ac, char **av)
+{
+	Options	opt;
+
+	opt.sizes.push_back(10);
+	opt.sizes.push_back(1000);
+	opt.sizes.push_back(100000);
+	opt.distributions = split("random,sorted,reverse,few-unique,organ-pipe,nearly-sorted");
+	opt.strategies = split("merge,radix,network,hybrid");
+	opt.containers = split("vector,list");
+	opt.trials = 5;
+	opt.warmup = 1;
+	opt.seed = 42;
+	opt.threads = 1;
+	opt.csv = false;
+	if (!parseOptions(ac, av, opt))
+	{
+		std::cerr << "Usage: " << av[0] << " [--sizes=N,...] [--distributions=NAME,...]"
+				  << " [--strategies=merge|radix|network|hybrid,...] [--containers=vector|list,...]"
+				  << " [--payloads=64|128|256,...] [--trials=N] [--warmup=N] [--seed=N]"
+				  << " [--threads=N] [--csv]" << std::endl
+				  << "Distributions: random, sorted, reverse, few-unique, organ-pipe,"
+				  << " nearly-sorted. Sizes accept 1e8." << std::endl;
+		return (1);
+	}
+
+	size_t	mismatches = 0;
+
+	if (opt.csv)
+		std::cout << "distribution,size,container,strategy,trials,median_ns,p99_ns,"
+				  << "comparisons,allocations" << std::endl;
+	for (size_t d = 0; d < opt.distributions.size(); ++d)
+	{
+		for (size_t z = 0; z < opt.sizes.size(); ++z)
+		{
+			std::vector<unsigned int>	input;
+
+			if (!generate(opt.distributions[d], opt.sizes[z], opt.seed, input))
+			{
+				std::cerr << RED << "Unknown distribution: " << opt.distributions[d] << NC << std::endl;
+				return (1);
+			}
+			std::vector<unsigned int>	expected(input);
+			std::sort(expected.begin(), expected.end());
+			std::vector<unsigned int>	ranks(input.size());
+			RankLess					byValue;
+			byValue.values = &input;
+			for (size_t i = 0; i < ranks.size(); ++i)
+				ranks[i] = static_cast<unsigned int>(i);
+			std::stable_sort(ranks.begin(), ranks.end(), byValue);
+
+			for (size_t c = 0; c < opt.containers.size(); ++c)
+			{
+				for (size_t s = 0; s < opt.strategies.size(); ++s)
+				{
+					Result	r;
+					bool	known;
+
+					if (opt.containers[c] == "vector")
+						known = measureStrategy<std::vector<unsigned int> >(opt.strategies[s], input, expected, opt, r);
+					else if (opt.containers[c] == "list")
+						known = measureStrategy<std::list<unsigned int> >(opt.strategies[s], input, expected, opt, r);
+					else
+						known = false;
+					if (!known)
+					{
+						std::cerr << RED << "Unknown container or strategy: " << opt.containers[c]
+								  << " / " << opt.strategies[s] << NC << std::endl;
+						return (1);
+					}
+					if (!r.sorted && ++mismatches <= 5)
+						std::cerr << RED << "Mismatch: " << opt.distributions[d] << " " << opt.sizes[z]
+								  << " " << opt.containers[c] << " " << opt.strategies[s] << NC << std::endl;
+					printResult(opt, opt.distributions[d], opt.sizes[z], opt.containers[c],
+						opt.strategies[s], r);
+				}
+				for (size_t p = 0; p < opt.payloads.size() * 2; ++p)
+				{
+					Result				r;
+					bool				known;
+					bool				stable = (p % 2 == 1);
+					size_t				bytes = opt.payloads[p / 2];
+					std::ostringstream	strategy;
+
+					strategy << (stable ? "indirect-stable-" : "indirect-") << bytes;
+					if (opt.containers[c] == "vector")
+						known = measurePayload<std::vector<Record<64> >, std::vector<Record<128> >,
+							std::vector<Record<256> > >(bytes, input, expected, ranks, stable, opt, r);
+					else if (opt.containers[c] == "list")
+						known = measurePayload<std::list<Record<64> >, std::list<Record<128> >,
+							std::list<Record<256> > >(bytes, input, expected, ranks, stable, opt, r);
+					else
+						known = false;
+					if (!known)
+					{
+						std::cerr << RED << "Unknown container or payload: " << opt.containers[c]
+								  << " / " << bytes << NC << std::endl;
+						return (1);
+					}
+					if (!r.sorted && ++mismatches <= 5)
+						std::cerr << RED << "Mismatch: " << opt.distributions[d] << " " << opt.sizes[z]
+								  << " " << opt.containers[c] << " " << strategy.str() << NC << std::endl;
+					printResult(opt, opt.distributions[d], opt.sizes[z], opt.containers[c],
+						strategy.str(), r);
+				}
+			}
+		}
+	}
+	return (mismatches == 0 ? 0 : 1);
+}
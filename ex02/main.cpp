@@ -11,20 +11,108 @@
 /* ************************************************************************** */
 
 #include "PmergeMe.hpp"
+#include "Profiler.hpp"
+#include <cstdlib>
 
 int	main(int ac, char **av)
 {
 	PmergeMe	pmerge;
+	int			first = 1;
+	std::string	input;
+	bool		binary = false;
+	std::string	external;
+	size_t		memory = 256;
+	std::vector<std::string>	batches;
+	size_t		top = 0;
+	size_t		partial = 0;
 
-	if (ac < 2)
+	while (ac > first && std::string(av[first]).compare(0, 2, "--") == 0)
 	{
-		std::cerr << "Usage: " << av[0] << " <numbers>" << std::endl;
+		std::string	option(av[first]);
+		if (option.compare(0, 10, "--threads=") == 0)
+			pmerge.setThreads(static_cast<unsigned int>(std::strtoul(option.c_str() + 10, NULL, 10)));
+		else if (option == "--strategy=merge")
+			pmerge.setStrategy(PmergeMe::MERGE_INSERTION);
+		else if (option == "--strategy=radix")
+			pmerge.setStrategy(PmergeMe::RADIX);
+		else if (option == "--strategy=network")
+			pmerge.setStrategy(PmergeMe::NETWORK);
+		else if (option == "--strategy=hybrid")
+			pmerge.setStrategy(PmergeMe::HYBRID);
+		else if (option == "--strategy=all")
+			pmerge.setStrategy(PmergeMe::ALL_STRATEGIES);
+		else if (option.compare(0, 8, "--input=") == 0)
+			input = option.substr(8);
+		else if (option == "--binary")
+			binary = true;
+		else if (option.compare(0, 11, "--external=") == 0)
+			external = option.substr(11);
+		else if (option == "--print=all")
+			pmerge.setEchoLimit(static_cast<size_t>(-1));
+		else if (option == "--print=none")
+			pmerge.setEchoLimit(0);
+		else if (option.compare(0, 8, "--print=") == 0)
+			pmerge.setEchoLimit(std::strtoul(option.c_str() + 8, NULL, 10));
+		else if (option.compare(0, 9, "--memory=") == 0)
+			memory = std::strtoul(option.c_str() + 9, NULL, 10);
+		else if (option.compare(0, 9, "--append=") == 0)
+			batches.push_back(option.substr(9));
+		else if (option.compare(0, 6, "--top=") == 0)
+			top = std::strtoul(option.c_str() + 6, NULL, 10);
+		else if (option.compare(0, 10, "--partial=") == 0)
+			partial = std::strtoul(option.c_str() + 10, NULL, 10);
+		else if (option == "--profile")
+			Profiler::enable();
+		else
+			break ;
+		first++;
+	}
+	if (ac <= first && input.empty())
+	{
+		std::cerr << "Usage: " << av[0] << " [--threads=N]"
+				  << " [--strategy=merge|radix|network|hybrid|all] [--print=all|none|N]"
+				  << " [--input=FILE|- [--binary] [--external=OUT|- [--memory=MB]]]"
+				  << " [--append=FILE|-]... [--top=K] [--partial=K] [--profile]"
+				  << " <numbers>" << std::endl;
 		return (1);
 	}
+	if (!external.empty())
+	{
+		if (input.empty() || ac > first)
+		{
+			std::cerr << "Error : --external sorts the file given with --input only" << std::endl;
+			return (1);
+		}
+		try
+		{
+			pmerge.sortExternal(input, binary, external, (memory == 0 ? 1 : memory) << 20);
+		}
+		catch (const std::exception &e)
+		{
+			std::cerr << "Error : " << e.what() << std::endl;
+			return (1);
+		}
+		Profiler::report(std::cerr);
+		return (0);
+	}
 	try
 	{
-		pmerge.fillContainer(av + 1, ac - 1);
+		pmerge.fillContainer(av + first, ac - first);
+		if (!input.empty())
+			pmerge.fillFromFile(input, binary);
+		// Queries alone select their values without sorting everything
+		if ((top != 0 || partial != 0) && batches.empty())
+		{
+			if (top != 0)
+				pmerge.printQuery(top, true);
+			if (partial != 0)
+				pmerge.printQuery(partial, false);
+			Profiler::report(std::cerr);
+			return (0);
+		}
 		pmerge.sortContainers();
+		for (size_t i = 0; i < batches.size(); ++i)
+			pmerge.mergeFromFile(batches[i], binary);
 		if (!(isSorted<std::vector<unsigned int> >(pmerge.getVector()))
 			&& !(isSorted<std::list<unsigned int> >(pmerge.getList())))
 		{
@@ -35,6 +123,11 @@ int	main(int ac, char **av)
 		{
 			std::cout << BLUE << "Containers are sorted successfully." << NC << std::endl;
 		}
+		if (top != 0)
+			pmerge.printQuery(top, true);
+		if (partial != 0)
+			pmerge.printQuery(partial, false);
+		Profiler::report(std::cerr);
 	}
 	catch(const std::exception& e)
 	{